@@ -22,13 +22,11 @@ typedef enum {
 // Function prototypes
 void DoorSystem_Init(void);
 uint8_t DoorSystem_Update(void);
-DoorState_t DoorSystem_GetState(void);
 void DoorSystem_SetState(DoorState_t state);
 void DoorSystem_ResetManualOverride(void);
-uint8_t DoorSystem_IsIgnitionOn(void);
-DoorOpenState_t DoorSystem_GetOpenState(void);
 void DoorSystem_SetOpenState(DoorOpenState_t state);
-
-extern SemaphoreHandle_t xLCDMutex;
+void DoorSystem_SetTask(TaskHandle_t task);
+void DoorSystem_SetOpenStateTask(TaskHandle_t task);
+void DoorSystem_Notify(void);
 
 #endif // DOOR_SYSTEM_H
\ No newline at end of file
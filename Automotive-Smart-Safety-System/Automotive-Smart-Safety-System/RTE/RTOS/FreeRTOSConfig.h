@@ -55,8 +55,9 @@
 
 //  <o>Total heap size [bytes] <0-0xFFFFFFFF>
 //  <i> Heap memory size in bytes.
+//  <i> Unused: every kernel object is statically allocated and no heap is linked.
 //  <i> Default: 8192
-#define configTOTAL_HEAP_SIZE                     ((size_t)8192)
+#define configTOTAL_HEAP_SIZE                     ((size_t)0)
 
 //  <o>Kernel tick frequency [Hz] <0-0xFFFFFFFF>
 //  <i> Kernel tick rate in Hz.
@@ -66,17 +67,20 @@
 //  <o>Timer task stack depth [words] <0-65535>
 //  <i> Stack for timer task in words.
 //  <i> Default: 80
-#define configTIMER_TASK_STACK_DEPTH              80
+//  <i> Raised for the power and stack reports, which printf from timer callbacks.
+#define configTIMER_TASK_STACK_DEPTH              160
 
 //  <o>Timer task priority <0-56>
 //  <i> Timer task priority.
 //  <i> Default: 40 (High)
-#define configTIMER_TASK_PRIORITY                 40
+//  <i> Below every task in the timing analysis (TIMING_BASE_PRIORITY), the callbacks only report and print.
+#define configTIMER_TASK_PRIORITY                 1
 
 //  <o>Timer queue length <0-1024>
 //  <i> Timer command queue length.
 //  <i> Default: 5
-#define configTIMER_QUEUE_LENGTH                  5
+//  <i> Room for a start and a stop of every timer Power_Update manages, queued while the timer task waits.
+#define configTIMER_QUEUE_LENGTH                  8
 
 //  <o>Preemption interrupt priority
 //  <i> Maximum priority of interrupts that are safe to call FreeRTOS API.
@@ -88,11 +92,13 @@
 //  <i> Default: 1
 #define configUSE_TIME_SLICING                    1
 
-//  <q>Use tickless idle
+//  <o>Use tickless idle
 //  <i> Enable low power tickless mode to stop the periodic tick interrupt during idle periods or
 //  <i> disable it to keep the tick interrupt running at all times.
+//  <i> Application selects the TM4C wake-timer implementation in power_system.c.
 //  <i> Default: 0
-#define configUSE_TICKLESS_IDLE                   0
+//    <0=>Disabled <1=>Port SysTick <2=>Application
+#define configUSE_TICKLESS_IDLE                   2
 
 //  <q>Idle should yield
 //  <i> Control Yield behaviour of the idle task.
@@ -109,8 +115,9 @@
 //  <q>Use idle hook
 //  <i> Enable callback function call on each idle task iteration.
 //  <i> Callback function vApplicationIdleHook implementation is required when idle hook is enabled.
+//  <i> Drains the trace recorder (trace.c).
 //  <i> Default: 0
-#define configUSE_IDLE_HOOK                       0
+#define configUSE_IDLE_HOOK                       1
 
 //  <q>Use tick hook
 //  <i> Enable callback function call during each tick interrupt.
@@ -124,6 +131,11 @@
 //  <i> Default: 0
 #define configUSE_DAEMON_TASK_STARTUP_HOOK        0
 
+//  <q>Generate run time statistics
+//  <i> Per task CPU time, counted on the DWT cycle counter (timing_analysis.c).
+//  <i> Default: 0
+#define configGENERATE_RUN_TIME_STATS             1
+
 //  <q>Use malloc failed hook
 //  <i> Enable callback function call when out of dynamic memory.
 //  <i> Callback function vApplicationMallocFailedHook implementation is required when malloc failed hook is enabled.
@@ -136,6 +148,11 @@
 //  <i> Default: 0
 #define configQUEUE_REGISTRY_SIZE                 0
 
+//  <o>Task notification array entries <1-32>
+//  <i> Number of notification slots per task. Slot 1 signals I2C1 transfer completion.
+//  <i> Default: 1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES     2
+
 // <h>Event Recorder Configuration
 // <i> Initialize and setup Event Recorder level filtering.
 // <i> Settings have no effect when Event Recorder is not present.
@@ -202,7 +219,7 @@
 //  <i> Enable or disable dynamic memory allocation.
 //  <i> When enabled RTOS objects can be created using RAM automatically allocated from the FreeRTOS heap.
 //  <i> Default: 1
-#define configSUPPORT_DYNAMIC_ALLOCATION          1
+#define configSUPPORT_DYNAMIC_ALLOCATION          0
 
 //  <q>Use kernel provided static memory
 //  <i> When enabled FreeRTOS kernel provides static memory for Idle and Timer tasks.
@@ -377,6 +394,28 @@
   /* Ensure Cortex-M port compatibility. */
   #define SysTick_Handler                         xPortSysTickHandler
 
+  /* Tickless idle on the TM4C Wide Timer 0A, see power_system.c */
+  #if (configUSE_TICKLESS_IDLE == 2)
+  extern void vApplicationSleep(uint32_t xExpectedIdleTime);
+  #define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime) vApplicationSleep(xExpectedIdleTime)
+  #endif
+
+  /* Run time stats on the DWT cycle counter, see timing_analysis.c */
+  #if (configGENERATE_RUN_TIME_STATS == 1)
+  extern void Timing_StartCycleCounter(void);
+  extern uint32_t Timing_RunTimeCounter(void);
+  #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() Timing_StartCycleCounter()
+  #define portGET_RUN_TIME_COUNTER_VALUE()         Timing_RunTimeCounter()
+  #endif
+
+  /* Context switch count for the CPU report, chained ahead of the EVR event
+     that freertos_evr.h would otherwise attach to this hook */
+  extern void Timing_TaskSwitchedIn(void *tcb);
+  #define traceTASK_SWITCHED_IN() do { \
+    Timing_TaskSwitchedIn(pxCurrentTCB); \
+    EvrFreeRTOSTasks_TaskSwitchedIn(pxCurrentTCB, uxTopReadyPriority); \
+  } while (0)
+
   #if (defined(__ARMCC_VERSION) || defined(__GNUC__) || defined(__ICCARM__))
   /* Include debug event definitions */
   #include "freertos_evr.h"
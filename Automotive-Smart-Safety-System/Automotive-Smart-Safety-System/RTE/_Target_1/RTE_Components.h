@@ -22,8 +22,6 @@
 #define RTE_RTOS_FreeRTOS_CORE          /* RTOS FreeRTOS Core */
 /* ARM.FreeRTOS::RTOS:Event Groups:11.1.0 */
 #define RTE_RTOS_FreeRTOS_EVENTGROUPS   /* RTOS FreeRTOS Event Groups */
-/* ARM.FreeRTOS::RTOS:Heap:Heap_4:11.1.0 */
-#define RTE_RTOS_FreeRTOS_HEAP_4        /* RTOS FreeRTOS Heap 4 */
 /* ARM.FreeRTOS::RTOS:Timers:11.1.0 */
 #define RTE_RTOS_FreeRTOS_TIMERS        /* RTOS FreeRTOS Timers */
 /* ARM::CMSIS:RTOS2:FreeRTOS:Cortex-M:11.1.0 */
@@ -0,0 +1,106 @@
+#ifndef BOARD_PINS_H
+#define BOARD_PINS_H
+
+#include <stdint.h>
+#include "gpio_access.h"
+
+// Every pin of the board as one descriptor: port letter, pin number, mode.
+// The GPIO_* macros below take a whole descriptor and resolve to constants,
+// so a pin access compiles to the same single load or store as the masked
+// Gpio_* call written out by hand, and a configuration to the same register
+// updates as the per-module code it replaces.
+#define PIN_LOCK_BTN         B, 0, GPIO_IN_PULLUP    // External button for LOCK
+#define PIN_DRIVE_SWITCH     F, 0, GPIO_IN_PULLUP    // Locked (NMI) pin, unlock first
+#define PIN_REVERSE_SWITCH   F, 1, GPIO_IN_PULLUP
+#define PIN_DOOR_SWITCH      F, 2, GPIO_IN_PULLUP    // Door open/closed switch
+#define PIN_IGNITION         F, 3, GPIO_IN_PULLUP    // Ignition switch
+#define PIN_UNLOCK_BTN       F, 4, GPIO_IN_PULLUP    // Onboard SW1 for UNLOCK
+#define PIN_SPEED_POT        E, 3, GPIO_ANALOG       // AIN0
+#define PIN_ULTRA_TRIGGER    C, 5, GPIO_OUT
+#define PIN_ULTRA_ECHO       C, 6, GPIO_ALT          // WT1CCP0, pull-down
+#define PIN_GREEN_LED        E, 0, GPIO_OUT
+#define PIN_YELLOW_LED       D, 6, GPIO_OUT
+#define PIN_RED_LED          D, 0, GPIO_OUT
+#define PIN_BUZZER           E, 5, GPIO_ALT          // M0PWM5
+#define PIN_I2C1_SCL         A, 6, GPIO_ALT
+#define PIN_I2C1_SDA         A, 7, GPIO_ALT          // Open-drain
+
+// Pin modes
+#define GPIO_IN              0
+#define GPIO_IN_PULLUP       1
+#define GPIO_OUT             2
+#define GPIO_ALT             3       // Digital alternate function, PCTL given at config
+#define GPIO_ANALOG          4
+
+// RCGCGPIO / PRGPIO bit of each port
+#define GPIO_CLOCK_A         (1 << 0)
+#define GPIO_CLOCK_B         (1 << 1)
+#define GPIO_CLOCK_C         (1 << 2)
+#define GPIO_CLOCK_D         (1 << 3)
+#define GPIO_CLOCK_E         (1 << 4)
+#define GPIO_CLOCK_F         (1 << 5)
+
+// Parts of a descriptor. The outer macro expands the descriptor into its
+// three fields before the inner one picks one out; it is variadic because
+// inside another GPIO_* macro the descriptor arrives already expanded.
+#define GPIO_PORT_OF(...)    GPIO_PORT_OF_(__VA_ARGS__)
+#define GPIO_NUM_OF(...)     GPIO_NUM_OF_(__VA_ARGS__)
+#define GPIO_MODE_OF(...)    GPIO_MODE_OF_(__VA_ARGS__)
+#define GPIO_CLOCK_OF(...)   GPIO_CLOCK_OF_(__VA_ARGS__)
+#define GPIO_MASK_OF(...)    (1UL << GPIO_NUM_OF(__VA_ARGS__))
+
+#define GPIO_PORT_OF_(port, num, mode)    GPIO_PORT##port
+#define GPIO_NUM_OF_(port, num, mode)     (num)
+#define GPIO_MODE_OF_(port, num, mode)    (mode)
+#define GPIO_CLOCK_OF_(port, num, mode)   GPIO_CLOCK_##port
+
+// Every port the board uses, enabled together by GpioAccess_Init
+#define BOARD_GPIO_CLOCKS   (GPIO_CLOCK_OF(PIN_LOCK_BTN) | GPIO_CLOCK_OF(PIN_DRIVE_SWITCH) | \
+                             GPIO_CLOCK_OF(PIN_REVERSE_SWITCH) | GPIO_CLOCK_OF(PIN_DOOR_SWITCH) | \
+                             GPIO_CLOCK_OF(PIN_IGNITION) | GPIO_CLOCK_OF(PIN_UNLOCK_BTN) | \
+                             GPIO_CLOCK_OF(PIN_SPEED_POT) | GPIO_CLOCK_OF(PIN_ULTRA_TRIGGER) | \
+                             GPIO_CLOCK_OF(PIN_ULTRA_ECHO) | GPIO_CLOCK_OF(PIN_GREEN_LED) | \
+                             GPIO_CLOCK_OF(PIN_YELLOW_LED) | GPIO_CLOCK_OF(PIN_RED_LED) | \
+                             GPIO_CLOCK_OF(PIN_BUZZER) | GPIO_CLOCK_OF(PIN_I2C1_SCL) | \
+                             GPIO_CLOCK_OF(PIN_I2C1_SDA))
+
+// Configure a pin for its mode; pctl is the alternate function of a GPIO_ALT
+// pin and ignored otherwise. Every argument is a constant at the call site,
+// the switch folds away.
+static inline void Gpio_Config(GPIOA_Type *port, uint32_t num, uint32_t mode, uint32_t pctl) {
+    uint32_t mask = 1UL << num;
+
+    switch (mode) {
+    case GPIO_IN_PULLUP:
+        port->PUR |= mask;
+        // Fall through
+    case GPIO_IN:
+        port->DIR &= ~mask;
+        port->DEN |= mask;
+        break;
+    case GPIO_OUT:
+        port->DIR |= mask;
+        port->DEN |= mask;
+        break;
+    case GPIO_ALT:
+        port->AFSEL |= mask;
+        port->PCTL = (port->PCTL & ~(0xFUL << (num * 4))) | (pctl << (num * 4));
+        port->AMSEL &= ~mask;
+        port->DEN |= mask;
+        break;
+    case GPIO_ANALOG:
+        port->AFSEL |= mask;
+        port->DEN &= ~mask;
+        port->AMSEL |= mask;
+        break;
+    }
+}
+
+// Pin access by descriptor
+#define GPIO_CONFIG(pin)             Gpio_Config(GPIO_PORT_OF(pin), GPIO_NUM_OF(pin), GPIO_MODE_OF(pin), 0)
+#define GPIO_CONFIG_ALT(pin, pctl)   Gpio_Config(GPIO_PORT_OF(pin), GPIO_NUM_OF(pin), GPIO_ALT, (pctl))
+#define GPIO_SET(pin)                Gpio_Set(GPIO_PORT_OF(pin), GPIO_MASK_OF(pin))
+#define GPIO_CLEAR(pin)              Gpio_Clear(GPIO_PORT_OF(pin), GPIO_MASK_OF(pin))
+#define GPIO_READ(pin)               Gpio_Read(GPIO_PORT_OF(pin), GPIO_MASK_OF(pin))
+
+#endif // BOARD_PINS_H
@@ -0,0 +1,141 @@
+#include "buzzer_system.h"
+#include "TM4C123GH6PM.h"
+#include "board_pins.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+// The tone is a PWM0 generator 2 square wave, so sounding costs no CPU. The
+// cadence runs on Timer 4A one-shots: one interrupt per on or off edge gates
+// the PWM output, independent of any task and of the tick.
+
+#define BUZZER_OUTPUT      (1 << 5)    // PWM0 ENABLE bit of M0PWM5
+
+// Generator B actions: high on load, low on compare B going down
+#define GEN_TONE           ((0x3 << 2) | (0x2 << 10))
+#define GEN_STEADY         (0x3 << 2)
+
+const BuzzerPattern_t BUZZER_DOOR_OPEN    = { BUZZER_TONE_HZ, 1000, 0, 0 };
+const BuzzerPattern_t BUZZER_PARK_FAR     = { BUZZER_TONE_HZ, 1000, 1000, 0 };
+const BuzzerPattern_t BUZZER_PARK_CAUTION = { BUZZER_TONE_HZ, 500, 500, 0 };
+const BuzzerPattern_t BUZZER_PARK_DANGER  = { BUZZER_TONE_HZ, 200, 200, 0 };
+
+// Pattern state, shared with TIMER4A_Handler
+static const BuzzerPattern_t *volatile activePattern = NULL;
+static volatile uint8_t soundOn = 0;
+static volatile uint16_t cyclesLeft = 0;
+
+static void ArmPhase(uint16_t ms) {
+    TIMER4->CTL = 0;
+    TIMER4->TAILR = (SystemCoreClock / 1000) * ms;
+    TIMER4->ICR = 1;
+    TIMER4->CTL = 1;
+}
+
+static void SetTone(uint16_t hz) {
+    uint32_t load;
+
+    PWM0->_2_CTL = 0;
+    if (hz == 0) {
+        PWM0->_2_LOAD = 0xFFFF;
+        PWM0->_2_GENB = GEN_STEADY;
+    } else {
+        load = (SystemCoreClock / BUZZER_PWM_DIV) / hz;
+        PWM0->_2_LOAD = load - 1;
+        PWM0->_2_CMPB = load / 2;
+        PWM0->_2_GENB = GEN_TONE;
+    }
+    PWM0->_2_CTL = 1;
+}
+
+void BuzzerSystem_Init(void) {
+    SYSCTL->RCGCPWM |= (1 << 0);          // Enable PWM0
+    SYSCTL->RCGCTIMER |= (1 << 4);        // Enable Timer4
+    while((SYSCTL->PRPWM & (1 << 0)) == 0);
+    while((SYSCTL->PRTIMER & (1 << 4)) == 0);
+
+    // PWM clock divider: /16 gives 1 MHz at 16 MHz, tones down to 16 Hz
+    SYSCTL->RCC = (SYSCTL->RCC & ~(0x7 << 17)) | (1 << 20) | (0x3 << 17);
+
+    // PE5 as M0PWM5
+    GPIO_CONFIG_ALT(PIN_BUZZER, 0x4);
+
+    // Output disabled (low) until a pattern plays
+    PWM0->ENABLE &= ~BUZZER_OUTPUT;
+    SetTone(BUZZER_TONE_HZ);
+
+    // Timer 4A times the on and off phases
+    TIMER4->CTL = 0;
+    TIMER4->CFG = 0;                      // 32-bit timer
+    TIMER4->TAMR = 0x1;                   // One-shot
+    TIMER4->ICR = 1;
+    TIMER4->IMR = 1;
+    NVIC_SetPriority(TIMER4A_IRQn, BUZZER_IRQ_PRIORITY);
+    NVIC_EnableIRQ(TIMER4A_IRQn);
+}
+
+// End of an on or off phase
+void TIMER4A_Handler(void) {
+    const BuzzerPattern_t *pattern = activePattern;
+
+    TIMER4->ICR = 1;
+    
+    // Nothing to time for a continuous tone (offMs 0), it stays on
+    if (pattern == NULL || pattern->offMs == 0) return;
+
+    if (soundOn) {
+        PWM0->ENABLE &= ~BUZZER_OUTPUT;
+        soundOn = 0;
+        if (pattern->repeat != 0 && --cyclesLeft == 0) {
+            activePattern = NULL;
+            return;
+        }
+        ArmPhase(pattern->offMs);
+    } else {
+        PWM0->ENABLE |= BUZZER_OUTPUT;
+        soundOn = 1;
+        ArmPhase(pattern->onMs);
+    }
+}
+
+// Start a pattern from its on phase. Asking for the pattern already playing
+// leaves its cadence alone, so callers may repeat the request every cycle.
+void BuzzerSystem_Play(const BuzzerPattern_t *pattern) {
+    if (pattern == NULL) {
+        BuzzerSystem_Stop();
+        return;
+    }
+    if (pattern == activePattern) return;
+
+    // Drop a timeout of the previous pattern still pending, its handler
+    // would otherwise run the new pattern from the wrong phase
+    taskENTER_CRITICAL();
+    TIMER4->CTL = 0;
+    TIMER4->ICR = 1;
+    NVIC_ClearPendingIRQ(TIMER4A_IRQn);
+    if (activePattern == NULL || pattern->toneHz != activePattern->toneHz) {
+        SetTone(pattern->toneHz);
+    }
+    activePattern = pattern;
+    cyclesLeft = pattern->repeat;
+    soundOn = 1;
+    PWM0->ENABLE |= BUZZER_OUTPUT;
+    if (pattern->offMs != 0) {
+        ArmPhase(pattern->onMs);
+    }
+    taskEXIT_CRITICAL();
+}
+
+void BuzzerSystem_Stop(void) {
+    taskENTER_CRITICAL();
+    TIMER4->CTL = 0;
+    TIMER4->ICR = 1;
+    NVIC_ClearPendingIRQ(TIMER4A_IRQn);
+    PWM0->ENABLE &= ~BUZZER_OUTPUT;
+    soundOn = 0;
+    activePattern = NULL;
+    taskEXIT_CRITICAL();
+}
+
+const BuzzerPattern_t *BuzzerSystem_GetPattern(void) {
+    return activePattern;
+}
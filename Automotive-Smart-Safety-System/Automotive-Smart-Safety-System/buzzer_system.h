@@ -0,0 +1,36 @@
+#ifndef BUZZER_SYSTEM_H
+#define BUZZER_SYSTEM_H
+
+#include <stdint.h>
+
+// Buzzer on PIN_BUZZER, PE5 (M0PWM5, PWM0 generator 2 output B). PE1 has no
+// PWM or timer output, the buzzer moved to the pin noted for it in tasks.c.
+#define BUZZER_PWM_DIV          16      // PWM clock = system clock / 16
+#define BUZZER_IRQ_PRIORITY     5       // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+
+// 0 drives the pin steadily while on (active buzzer); a frequency gives a
+// square wave for a passive one
+#define BUZZER_TONE_HZ          0
+
+// A pattern sounds for onMs, stays silent for offMs and repeats. offMs 0 is
+// a continuous tone, repeat 0 repeats forever.
+typedef struct {
+    uint16_t toneHz;
+    uint16_t onMs;
+    uint16_t offMs;
+    uint16_t repeat;             // On/off cycles before the buzzer falls silent
+} BuzzerPattern_t;
+
+// Patterns of the current warnings
+extern const BuzzerPattern_t BUZZER_DOOR_OPEN;       // Door open while moving
+extern const BuzzerPattern_t BUZZER_PARK_FAR;        // Beyond SAFE_DISTANCE
+extern const BuzzerPattern_t BUZZER_PARK_CAUTION;    // Beyond CAUTION_DISTANCE
+extern const BuzzerPattern_t BUZZER_PARK_DANGER;     // Closer than CAUTION_DISTANCE
+
+// Function prototypes
+void BuzzerSystem_Init(void);
+void BuzzerSystem_Play(const BuzzerPattern_t *pattern);   // No restart if already playing
+void BuzzerSystem_Stop(void);
+const BuzzerPattern_t *BuzzerSystem_GetPattern(void);     // NULL when silent
+
+#endif // BUZZER_SYSTEM_H
@@ -0,0 +1,144 @@
+#include "cyclic_executive.h"
+
+#ifdef CYCLIC_EXECUTIVE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "display.h"
+#include "tasks.h"
+#include "timing_analysis.h"
+#include "stack_monitor.h"
+#include "TM4C123GH6PM.h"
+#include <stdio.h>
+
+// Cyclic executive: the schedule table lists the jobs of each minor frame in
+// run order. Frames are released with vTaskDelayUntil, so a late frame does
+// not shift the ones after it. Jobs poll their inputs once per frame; no job
+// blocks and no task notifications are used, so ignition off does not park
+// anything and the core sleeps between frames instead.
+
+typedef void (*CyclicJob_t)(void);
+
+typedef struct {
+    CyclicJob_t job;             // NULL ends the frame
+    TimingTask_t timing;         // WCET record of the job
+} CyclicSlot_t;
+
+static void DoorLockJob(void);
+static void UltrasonicJob(void);
+static void DisplayJob(void);
+
+static const CyclicSlot_t schedule[CYCLIC_MINOR_FRAMES][CYCLIC_MAX_JOBS + 1] = {
+    {
+        { Tasks_GearStep,            TIMING_GEAR },
+        { DoorLockJob,               TIMING_DOOR_LOCK },
+        { Tasks_DoorOpenCloseStep,   TIMING_DOOR_OPEN_CLOSE },
+        { Tasks_SpeedStep,           TIMING_SPEED },
+        { Tasks_IgnitionStatusStep,  TIMING_IGNITION_STATUS },
+        { NULL,                      TIMING_TASK_COUNT }
+    },
+    {
+        { Tasks_GearStep,            TIMING_GEAR },
+        { UltrasonicJob,             TIMING_ULTRASONIC },
+        { DisplayJob,                TIMING_DISPLAY },
+        { NULL,                      TIMING_TASK_COUNT }
+    }
+};
+
+static StackType_t executiveStack[CYCLIC_STACK_SIZE];
+static StaticTask_t executiveTcb;
+static CyclicStats_t stats = {0};
+
+// Door changes are picked up on the next frame, the change flag is not needed
+static void DoorLockJob(void) {
+    (void)Tasks_DoorLockStep();
+}
+
+// Ranging runs on its own timers, use the latest measurement every frame
+static void UltrasonicJob(void) {
+    (void)Tasks_UltrasonicStep(1);
+}
+
+// Apply every queued update, then redraw what changed
+static void DisplayJob(void) {
+    DisplayUpdate_t update;
+
+    while (xQueueReceive(xDisplayQueue, &update, 0) == pdPASS) {
+        Display_Apply(&update);
+    }
+    Display_Refresh();
+}
+
+static uint32_t CyclesToUs(uint32_t cycles) {
+    return cycles / (SystemCoreClock / 1000000);
+}
+
+static void vCyclicExecutiveTask(void *pvParameters) {
+    uint32_t frameCycles = (SystemCoreClock / 1000) * CYCLIC_MINOR_FRAME_MS;
+    TickType_t lastWake;
+    uint32_t expected;
+    uint8_t frame = 0;
+
+    Tasks_InitUltrasonic();
+    Tasks_InitDisplay();
+    Display_Refresh();
+
+    lastWake = xTaskGetTickCount();
+    expected = Timing_RunTimeCounter();
+
+    while(1) {
+        uint32_t release = Timing_RunTimeCounter();
+        int32_t offset = (int32_t)(release - expected);
+        uint32_t jitter = (offset < 0) ? (uint32_t)-offset : (uint32_t)offset;
+        uint32_t work;
+
+        if (stats.frames > 0 && CyclesToUs(jitter) > stats.maxJitterUs) {
+            stats.maxJitterUs = CyclesToUs(jitter);
+        }
+
+        for (const CyclicSlot_t *slot = schedule[frame]; slot->job != NULL; slot++) {
+            Timing_Begin(slot->timing);
+            slot->job();
+            Timing_End(slot->timing);
+        }
+
+        work = Timing_RunTimeCounter() - release;
+        if (CyclesToUs(work) > stats.maxFrameUs) {
+            stats.maxFrameUs = CyclesToUs(work);
+        }
+        if (work > frameCycles) {
+            stats.overruns++;
+        }
+        stats.frames++;
+
+        if (stats.frames % CYCLIC_REPORT_FRAMES == 0) {
+            printf("Cyclic: %lu frames, jitter max %lu us, frame max %lu us, %lu overruns\n",
+                   (unsigned long)stats.frames, (unsigned long)stats.maxJitterUs,
+                   (unsigned long)stats.maxFrameUs, (unsigned long)stats.overruns);
+            Timing_ReportOverruns();
+        }
+
+        frame = (frame + 1) % CYCLIC_MINOR_FRAMES;
+        expected += frameCycles;
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(CYCLIC_MINOR_FRAME_MS));
+    }
+}
+
+void CyclicExecutive_Init(void) {
+    TaskHandle_t task;
+
+    // Takes the top priority of the task set it replaces, the 25 ms
+    // ultrasonic job; only the input sampler stays above it
+    task = xTaskCreateStatic(vCyclicExecutiveTask, "Cyclic", CYCLIC_STACK_SIZE, NULL,
+                             Timing_Priority(TIMING_ULTRASONIC), executiveStack, &executiveTcb);
+    StackMonitor_Register(task, CYCLIC_STACK_SIZE);
+}
+
+void CyclicExecutive_GetStats(CyclicStats_t *out) {
+    taskENTER_CRITICAL();
+    *out = stats;
+    taskEXIT_CRITICAL();
+}
+
+#endif // CYCLIC_EXECUTIVE
@@ -0,0 +1,31 @@
+#ifndef CYCLIC_EXECUTIVE_H
+#define CYCLIC_EXECUTIVE_H
+
+#include <stdint.h>
+
+// Time-triggered alternative to the seven task set, selected by defining
+// CYCLIC_EXECUTIVE in the compiler options. One task runs every job from a
+// static schedule table, released from absolute times.
+
+// Frame layout: the gear job runs every minor frame, the rest once per major
+// frame, so the major frame equals the 100ms period of the other tasks
+#define CYCLIC_MINOR_FRAME_MS    50
+#define CYCLIC_MINOR_FRAMES      2       // Minor frames per major frame
+#define CYCLIC_MAX_JOBS          5       // Jobs in one minor frame
+#define CYCLIC_STACK_SIZE        256     // Words, runs every job and prints reports
+#define CYCLIC_REPORT_FRAMES     200     // Minor frames between reports (10 s)
+
+typedef struct {
+    uint32_t frames;             // Minor frames run
+    uint32_t maxJitterUs;        // Worst release deviation from the frame grid
+    uint32_t maxFrameUs;         // Longest minor frame of work
+    uint32_t overruns;           // Frames whose work spilled into the next one
+} CyclicStats_t;
+
+// Function prototypes
+#ifdef CYCLIC_EXECUTIVE
+void CyclicExecutive_Init(void);              // Creates the executive task
+void CyclicExecutive_GetStats(CyclicStats_t *stats);
+#endif
+
+#endif // CYCLIC_EXECUTIVE_H
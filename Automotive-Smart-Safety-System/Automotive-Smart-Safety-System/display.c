@@ -0,0 +1,275 @@
+#include "display.h"
+#include "lcd.h"
+#include "gear_system.h"
+#include "trace.h"
+#include "text_format.h"
+#include "vehicle_state.h"
+
+// How long transient layers stay up without being refreshed
+#define DOOR_STATUS_TIME_MS      2000   // Door opened/closed message
+#define IGNITION_STATUS_TIME_MS  1000   // Ignition on/off message
+#define DISTANCE_STALE_TIME_MS   500    // Parking distance without a new reading
+#define DISPLAY_RETRY_TIME_MS    100    // Redraw after a failed LCD transfer
+
+// shownLayer of a line whose last draw failed, never equal to a winner
+#define LINE_NOT_SHOWN           (-2)
+
+// Line layers, lowest index wins
+enum { LINE1_STATUS, LINE1_DOOR, LINE1_LAYERS };
+enum { LINE2_WARNING, LINE2_DISTANCE, LINE2_SPEED, LINE2_LAYERS };
+
+// Canned line 1 messages
+typedef enum {
+    DISPLAY_STATUS_DOOR_LOCKED,
+    DISPLAY_STATUS_DOOR_UNLOCKED,
+    DISPLAY_STATUS_DOOR_OPENED,
+    DISPLAY_STATUS_DOOR_CLOSED,
+    DISPLAY_STATUS_IGNITION_ON,
+    DISPLAY_STATUS_IGNITION_OFF
+} DisplayStatus_t;
+
+typedef struct {
+    uint8_t active;
+    uint8_t expires;           // Layer drops out at 'expiry' when set
+    int32_t value;
+    TickType_t expiry;
+} DisplayLayer_t;
+
+typedef struct {
+    uint8_t row;
+    uint8_t count;
+    DisplayLayer_t layer[DISPLAY_MAX_LAYERS];
+    int8_t shownLayer;         // Layer currently on the panel, -1 for none
+    int32_t shownValue;
+} DisplayLine_t;
+
+// Single character cell beside the layers of a line, drawn on its own
+typedef struct {
+    uint8_t row;
+    uint8_t col;
+    int32_t value;
+    int32_t shownValue;        // DISPLAY_CLEAR until first drawn
+} DisplayCell_t;
+
+QueueHandle_t xDisplayQueue = NULL;
+static StaticQueue_t displayQueueBuffer;
+static uint8_t displayQueueStorage[DISPLAY_QUEUE_LEN * sizeof(DisplayUpdate_t)];
+
+static DisplayLine_t lines[LCD_ROWS] = {
+    { 0, LINE1_LAYERS, {{0}}, -1, 0 },
+    { 1, LINE2_LAYERS, {{0}}, -1, 0 }
+};
+
+// Gear in the last column of line 1, right of the 14 character status
+static DisplayCell_t gearCell = { 0, LCD_COLS - 1, GEAR_PARK, DISPLAY_CLEAR };
+
+static const char *const statusText[] = {
+    "Door: Locked  ",   // DISPLAY_STATUS_DOOR_LOCKED
+    "Door: Unlocked",   // DISPLAY_STATUS_DOOR_UNLOCKED
+    "Door: Opened  ",   // DISPLAY_STATUS_DOOR_OPENED
+    "Door: Closed  ",   // DISPLAY_STATUS_DOOR_CLOSED
+    "Ignition: ON  ",   // DISPLAY_STATUS_IGNITION_ON
+    "Ignition: OFF "    // DISPLAY_STATUS_IGNITION_OFF
+};
+
+#define STATUS_COUNT  ((int32_t)(sizeof(statusText) / sizeof(statusText[0])))
+
+// Create the update queue, must run before the scheduler starts
+void Display_Init(void) {
+    xDisplayQueue = xQueueCreateStatic(DISPLAY_QUEUE_LEN, sizeof(DisplayUpdate_t),
+                                       displayQueueStorage, &displayQueueBuffer);
+}
+
+// Post an update without blocking. Returns pdFAIL if the queue is full.
+BaseType_t Display_Post(DisplayField_t field, int32_t value) {
+    DisplayUpdate_t update;
+
+    if (xDisplayQueue == NULL) return pdFAIL;
+
+    update.field = (uint8_t)field;
+    update.value = value;
+    return xQueueSend(xDisplayQueue, &update, 0);
+}
+
+// Wake the server to pick up the vehicle state. A full queue needs no retry,
+// the server is already behind and refreshes after draining it.
+void Display_Notify(void) {
+    (void)Display_Post(DISPLAY_FIELD_STATE, 0);
+}
+
+static const char *GearText(Gear_t gear) {
+    switch (gear) {
+        case GEAR_PARK:
+            return "P";
+        case GEAR_DRIVE:
+            return "D";
+        case GEAR_REVERSE:
+            return "R";
+        default:
+            return "?";        // One cell, no room for a word
+    }
+}
+
+// Activate or clear one layer; timeMs of 0 means the layer never expires
+static void SetLayer(uint8_t row, uint8_t index, int32_t value, uint32_t timeMs) {
+    DisplayLayer_t *layer = &lines[row].layer[index];
+
+    if (value == DISPLAY_CLEAR) {
+        layer->active = 0;
+        return;
+    }
+
+    layer->active = 1;
+    layer->value = value;
+    layer->expires = (timeMs != 0);
+    if (layer->expires) {
+        layer->expiry = xTaskGetTickCount() + pdMS_TO_TICKS(timeMs);
+    }
+}
+
+// Draw the winning layer of a line, returns I2C_OK once it is on the panel
+static int RenderLine(const DisplayLine_t *line, int8_t index, int32_t value) {
+    LCD_Message_t displayMsg;
+    char *end = displayMsg.line2 + LCD_COLS;
+    char *p;
+
+    LCD_set_cursor(line->row, 0);
+
+    if (index < 0) {
+        return LCD_write_string(line->row == 0 ? "              " : "                ");
+    }
+
+    if (line->row == 0) {
+        // Both line 1 layers carry a canned status message
+        if (value >= 0 && value < STATUS_COUNT) {
+            return LCD_write_string(statusText[value]);
+        }
+        return I2C_OK;
+    }
+
+    switch (index) {
+        case LINE2_WARNING:
+            return LCD_write_string("WARNING: Door Open! ");
+        case LINE2_DISTANCE:
+            p = Format_Text(displayMsg.line2, end, "Dist=");
+            p = Format_Tenths(p, end, value);
+            p = Format_Text(p, end, " cm");
+            Format_Pad(p, end);
+            return LCD_write_string(displayMsg.line2);
+        case LINE2_SPEED:
+            p = Format_Text(displayMsg.line2, end, "Speed=");
+            p = Format_Tenths(p, end, value);
+            p = Format_Text(p, end, " km/h");
+            Format_Pad(p, end);
+            return LCD_write_string(displayMsg.line2);
+        default:
+            return I2C_OK;
+    }
+}
+
+// Update the layer model with one record. Drawing happens in Display_Refresh.
+void Display_Apply(const DisplayUpdate_t *update) {
+    int32_t value = update->value;
+
+    switch (update->field) {
+        case DISPLAY_FIELD_DISTANCE:
+            SetLayer(1, LINE2_DISTANCE, value, DISTANCE_STALE_TIME_MS);
+            break;
+
+        default:
+            // DISPLAY_FIELD_STATE: the refresh reads the snapshot
+            break;
+    }
+}
+
+// Level layers straight from the vehicle state, and the transient messages
+// for the door and ignition changes seen since the last refresh
+static void SyncVehicleState(void) {
+    static VehicleState_t last;
+    static uint8_t synced = 0;
+    VehicleState_t vehicle;
+    int32_t doorMessage;
+
+    VehicleState_Read(&vehicle);
+    doorMessage = (vehicle.doorLock == DOORS_UNLOCKED) ?
+                  DISPLAY_STATUS_DOOR_UNLOCKED : DISPLAY_STATUS_DOOR_LOCKED;
+
+    // A lock change is news in itself, drop any older transient message
+    if (synced && vehicle.doorLock != last.doorLock) {
+        lines[0].layer[LINE1_STATUS].active = 0;
+    }
+    SetLayer(0, LINE1_DOOR, doorMessage, 0);
+
+    if (synced && vehicle.doorOpen != last.doorOpen) {
+        SetLayer(0, LINE1_STATUS, (vehicle.doorOpen == DOOR_OPEN) ?
+                 DISPLAY_STATUS_DOOR_OPENED : DISPLAY_STATUS_DOOR_CLOSED, DOOR_STATUS_TIME_MS);
+    }
+    if (synced && vehicle.ignitionOn != last.ignitionOn) {
+        SetLayer(0, LINE1_STATUS, vehicle.ignitionOn ?
+                 DISPLAY_STATUS_IGNITION_ON : DISPLAY_STATUS_IGNITION_OFF, IGNITION_STATUS_TIME_MS);
+    }
+
+    SetLayer(1, LINE2_WARNING, (vehicle.doorOpen == DOOR_OPEN && vehicle.speed > 0) ?
+             1 : DISPLAY_CLEAR, 0);
+    SetLayer(1, LINE2_SPEED, SPEED_TO_TENTHS(vehicle.speed), 0);
+    gearCell.value = vehicle.gear;
+
+    last = vehicle;
+    synced = 1;
+}
+
+// Expire layers, redraw lines whose winner changed and return how long the
+// server may sleep before the next expiry (portMAX_DELAY if none is pending)
+TickType_t Display_Refresh(void) {
+    TickType_t now;
+    TickType_t wait = portMAX_DELAY;
+    TickType_t retry = pdMS_TO_TICKS(DISPLAY_RETRY_TIME_MS);
+
+    SyncVehicleState();
+    now = xTaskGetTickCount();
+
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        DisplayLine_t *line = &lines[row];
+        int8_t winner = -1;
+
+        for (uint8_t i = 0; i < line->count; i++) {
+            DisplayLayer_t *layer = &line->layer[i];
+            if (!layer->active) continue;
+
+            if (layer->expires) {
+                TickType_t remaining = layer->expiry - now;
+                if ((int32_t)remaining <= 0) {
+                    layer->active = 0;
+                    continue;
+                }
+                if (remaining < wait) wait = remaining;
+            }
+
+            if (winner < 0) winner = (int8_t)i;
+        }
+
+        if (winner != line->shownLayer ||
+            (winner >= 0 && line->layer[winner].value != line->shownValue)) {
+            line->shownLayer = winner;
+            line->shownValue = (winner >= 0) ? line->layer[winner].value : 0;
+            Trace_Record(TRACE_LCD_FLUSH_START, row);
+            if (RenderLine(line, winner, line->shownValue) != I2C_OK) {
+                // Not on the panel, draw the line again after a pause
+                line->shownLayer = LINE_NOT_SHOWN;
+                if (retry < wait) wait = retry;
+            }
+            Trace_Record(TRACE_LCD_FLUSH_END, row);
+        }
+    }
+
+    if (gearCell.value != gearCell.shownValue) {
+        gearCell.shownValue = gearCell.value;
+        LCD_set_cursor(gearCell.row, gearCell.col);
+        if (LCD_write_string(GearText((Gear_t)gearCell.value)) != I2C_OK) {
+            gearCell.shownValue = DISPLAY_CLEAR;
+            if (retry < wait) wait = retry;
+        }
+    }
+
+    return wait;
+}
@@ -2,6 +2,15 @@
 #define DISPLAY_H
 
 #include <stdint.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+
+// Display server configuration
+#define DISPLAY_QUEUE_LEN   16
+#define DISPLAY_MAX_LAYERS  3
+
+// Value that removes a layered field from its line
+#define DISPLAY_CLEAR       (-1)
 
 // Structure to hold LCD messages
 typedef struct {
@@ -9,4 +18,34 @@ typedef struct {
     char line2[17];  // Second line message
 } LCD_Message_t;
 
-#endif // DISPLAY_H 
\ No newline at end of file
+// Fields a producer can update on the display. Each line shows the highest
+// ranked active layer; a line is only redrawn when that layer or its value
+// changes.
+//
+// Levels (door lock, gear, door-open warning, speed) and the door and ignition
+// change messages are not carried by the queue: the server takes them from
+// the vehicle_state snapshot on every refresh. DISPLAY_FIELD_STATE only wakes
+// it, so a post lost to a full queue loses nothing; the queue is then being
+// drained and the next refresh reads the new state anyway.
+typedef enum {
+    DISPLAY_FIELD_STATE,       // Vehicle state changed, value unused
+    DISPLAY_FIELD_DISTANCE     // Line 2 middle layer (expires), value in 0.1 cm
+} DisplayField_t;
+
+// Update record posted to the display server
+typedef struct {
+    uint8_t field;             // DisplayField_t
+    int32_t value;
+} DisplayUpdate_t;
+
+// Function prototypes
+void Display_Init(void);
+BaseType_t Display_Post(DisplayField_t field, int32_t value);
+void Display_Notify(void);                 // Vehicle state changed, never needs a retry
+void Display_Apply(const DisplayUpdate_t *update);
+TickType_t Display_Refresh(void);
+
+// Queue feeding the display server task, the only LCD owner
+extern QueueHandle_t xDisplayQueue;
+
+#endif // DISPLAY_H
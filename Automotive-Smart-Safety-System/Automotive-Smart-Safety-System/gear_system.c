@@ -1,56 +1,59 @@
 #include "gear_system.h"
 #include "TM4C123GH6PM.h"
+#include "board_pins.h"
 #include "speed_system.h"
+#include "input_system.h"
+#include "vehicle_state.h"
 #include <stdio.h>
 
-// Global variables
-static Gear_t currentGear = GEAR_DRIVE;  // Default to Drive
+// Gear switches in the debounced input word
+#define DRIVE_SWITCH_INPUT    INPUT_PF(0)
+#define REVERSE_SWITCH_INPUT  INPUT_PF(1)
 
 // Speed threshold for gear change
-#define GEAR_CHANGE_SPEED_THRESHOLD 5.0f  // Increased threshold to 5 km/h for more stable gear changes
+#define GEAR_CHANGE_SPEED_THRESHOLD SPEED_KMH(5)  // Increased threshold to 5 km/h for more stable gear changes
 
 // Initialize GPIO for gear switches
 void GearSystem_Init(void) {
-    // Enable GPIO port for switches (using Port F)
-    SYSCTL->RCGCGPIO |= (1 << 5);  // Enable GPIOF
-    while((SYSCTL->PRGPIO & (1 << 5)) == 0); // Wait for GPIOF to be ready
-    
-    // Unlock PF0
-    GPIOF->LOCK = 0x4C4F434B;
-    GPIOF->CR |= (1 << 0);
-    GPIOF->LOCK = 0;
+    // Unlock PF0, the port is clocked by GpioAccess_Init
+    GPIO_PORT_OF(PIN_DRIVE_SWITCH)->LOCK = 0x4C4F434B;
+    GPIO_PORT_OF(PIN_DRIVE_SWITCH)->CR |= GPIO_MASK_OF(PIN_DRIVE_SWITCH);
+    GPIO_PORT_OF(PIN_DRIVE_SWITCH)->LOCK = 0;
     
     // Configure PF0 and PF1 as inputs with pull-up resistors
-    GPIOF->DIR &= ~((1 << 0) | (1 << 1));  // Set as inputs
-    GPIOF->PUR |= ((1 << 0) | (1 << 1));   // Enable pull-up resistors
-    GPIOF->DEN |= ((1 << 0) | (1 << 1));   // Enable digital function
+    GPIO_CONFIG(PIN_DRIVE_SWITCH);
+    GPIO_CONFIG(PIN_REVERSE_SWITCH);
 }
 
-// Update gear reading
+// Update gear reading. The gear is published in vehicle_state.c (Drive at
+// power-on) and this module is its only writer.
 uint8_t GearSystem_Update(void) {
     uint32_t switchState;
     static Gear_t lastGear = GEAR_DRIVE;
-    float currentSpeed = SpeedSystem_GetCurrentSpeed();
+    VehicleState_t vehicle;
+    
+    VehicleState_Read(&vehicle);
+    Gear_t currentGear = vehicle.gear;
     
-    // Read switch states
-    switchState = GPIOF->DATA & ((1 << 0) | (1 << 1));
+    // Debounced switch states
+    switchState = InputSystem_GetStable();
     
     // Only allow gear change if speed is below threshold
-    if (currentSpeed <= GEAR_CHANGE_SPEED_THRESHOLD) {
+    if (vehicle.speed <= GEAR_CHANGE_SPEED_THRESHOLD) {
         // Determine gear based on switch states
-        if (switchState & (1 << 0) && !(switchState & (1 << 1))) {  // Drive switch pressed
+        if (switchState & DRIVE_SWITCH_INPUT && !(switchState & REVERSE_SWITCH_INPUT)) {  // Drive switch pressed
             if (currentGear != GEAR_DRIVE) {
-                currentGear = GEAR_DRIVE;
+                VehicleState_SetGear(GEAR_DRIVE);
                 return 1;  // Indicate gear changed
             }
-        } else if (switchState & (1 << 1) && !(switchState & (1 << 0))) {  // Reverse switch pressed
+        } else if (switchState & REVERSE_SWITCH_INPUT && !(switchState & DRIVE_SWITCH_INPUT)) {  // Reverse switch pressed
             if (currentGear != GEAR_REVERSE) {
-                currentGear = GEAR_REVERSE;
+                VehicleState_SetGear(GEAR_REVERSE);
                 return 1;  // Indicate gear changed
             }
         }	else {
 					if(currentGear != GEAR_PARK) {
-                currentGear = GEAR_PARK;
+                VehicleState_SetGear(GEAR_PARK);
                 return 1;  // Indicate gear changed
 					}
 				}
@@ -58,8 +61,3 @@ uint8_t GearSystem_Update(void) {
     
     return 0;  // No change
 }
-
-// Get current gear
-Gear_t GearSystem_GetCurrentGear(void) {
-    return currentGear;
-} 
\ No newline at end of file
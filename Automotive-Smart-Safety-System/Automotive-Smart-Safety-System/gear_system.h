@@ -17,9 +17,5 @@ typedef enum {
 // Function declarations
 void GearSystem_Init(void);
 uint8_t GearSystem_Update(void);  // Returns 1 if gear changed, 0 if not
-Gear_t GearSystem_GetCurrentGear(void);
-
-// External declarations
-extern SemaphoreHandle_t xLCDMutex;
 
 #endif // GEAR_SYSTEM_H 
\ No newline at end of file
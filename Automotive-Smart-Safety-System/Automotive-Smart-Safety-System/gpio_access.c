@@ -0,0 +1,81 @@
+#include "gpio_access.h"
+#include "board_pins.h"
+
+// Clock every port the board uses with one combined mask and one wait
+void GpioAccess_Init(void) {
+    SYSCTL->RCGCGPIO |= BOARD_GPIO_CLOCKS;
+    while((SYSCTL->PRGPIO & BOARD_GPIO_CLOCKS) != BOARD_GPIO_CLOCKS);
+    
+#ifndef GPIO_APB
+    SYSCTL->GPIOHBCTL |= GPIO_ALL_PORTS;
+#endif
+}
+
+#ifdef GPIO_BENCHMARK
+#include <stdio.h>
+
+// Toggles the green LED, the output arbiter must have set it up
+#define BENCH_PIN          GPIO_MASK_OF(PIN_GREEN_LED)
+#define BENCH_PORT_BIT     GPIO_CLOCK_OF(PIN_GREEN_LED)
+#define BENCH_LOOPS        1000      // Eight level changes each
+#define BENCH_TOGGLES      (BENCH_LOOPS * 8)
+
+// Pin up and down with a read-modify-write of GPIODATA
+static uint32_t ToggleRmw(GPIOA_Type *port) {
+    uint32_t start = DWT->CYCCNT;
+
+    for (uint32_t i = 0; i < BENCH_LOOPS; i++) {
+        port->DATA |= BENCH_PIN;
+        port->DATA &= ~BENCH_PIN;
+        port->DATA |= BENCH_PIN;
+        port->DATA &= ~BENCH_PIN;
+        port->DATA |= BENCH_PIN;
+        port->DATA &= ~BENCH_PIN;
+        port->DATA |= BENCH_PIN;
+        port->DATA &= ~BENCH_PIN;
+    }
+    return DWT->CYCCNT - start;
+}
+
+// The same with single masked stores
+static uint32_t ToggleMasked(GPIOA_Type *port) {
+    uint32_t start = DWT->CYCCNT;
+
+    for (uint32_t i = 0; i < BENCH_LOOPS; i++) {
+        Gpio_Set(port, BENCH_PIN);
+        Gpio_Clear(port, BENCH_PIN);
+        Gpio_Set(port, BENCH_PIN);
+        Gpio_Clear(port, BENCH_PIN);
+        Gpio_Set(port, BENCH_PIN);
+        Gpio_Clear(port, BENCH_PIN);
+        Gpio_Set(port, BENCH_PIN);
+        Gpio_Clear(port, BENCH_PIN);
+    }
+    return DWT->CYCCNT - start;
+}
+
+// Cycles per pin change, read-modify-write against masked store, on either
+// aperture. Port E is moved between the apertures for the run, so call it
+// before the scheduler starts and before anything else drives the port.
+void GpioAccess_Benchmark(void) {
+    uint32_t hbctl = SYSCTL->GPIOHBCTL;
+    uint32_t apbRmw, apbMasked, ahbRmw, ahbMasked;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    SYSCTL->GPIOHBCTL = hbctl & ~BENCH_PORT_BIT;
+    apbRmw = ToggleRmw(GPIOE);
+    apbMasked = ToggleMasked(GPIOE);
+
+    SYSCTL->GPIOHBCTL = hbctl | BENCH_PORT_BIT;
+    ahbRmw = ToggleRmw(GPIOE_AHB);
+    ahbMasked = ToggleMasked(GPIOE_AHB);
+
+    SYSCTL->GPIOHBCTL = hbctl;
+
+    printf("GPIO benchmark (cycles/toggle): APB rmw=%lu masked=%lu, AHB rmw=%lu masked=%lu\n",
+           (unsigned long)(apbRmw / BENCH_TOGGLES), (unsigned long)(apbMasked / BENCH_TOGGLES),
+           (unsigned long)(ahbRmw / BENCH_TOGGLES), (unsigned long)(ahbMasked / BENCH_TOGGLES));
+}
+#endif
@@ -0,0 +1,60 @@
+#ifndef GPIO_ACCESS_H
+#define GPIO_ACCESS_H
+
+#include <stdint.h>
+#include "TM4C123GH6PM.h"
+
+// Ports are reached through the AHB aperture, one bus cycle shorter than the
+// legacy APB one. The two apertures exclude each other per port, so every
+// GPIO access goes through these names and GpioAccess_Init runs before the
+// first. Build with GPIO_APB to fall back to the APB addresses.
+#ifdef GPIO_APB
+#define GPIO_PORTA GPIOA
+#define GPIO_PORTB GPIOB
+#define GPIO_PORTC GPIOC
+#define GPIO_PORTD GPIOD
+#define GPIO_PORTE GPIOE
+#define GPIO_PORTF GPIOF
+#else
+#define GPIO_PORTA GPIOA_AHB
+#define GPIO_PORTB GPIOB_AHB
+#define GPIO_PORTC GPIOC_AHB
+#define GPIO_PORTD GPIOD_AHB
+#define GPIO_PORTE GPIOE_AHB
+#define GPIO_PORTF GPIOF_AHB
+#endif
+
+#define GPIO_ALL_PORTS 0x3F    // Ports A to F
+
+// GPIODATA is mirrored over 256 words; address bits 9:2 mask the access, so
+// pins outside 'pins' are neither read nor written. A single store changes
+// only its own pins, no read-modify-write and no lock against other users
+// of the port.
+#define GPIO_DATA_MASKED(port, pins) \
+    (*((volatile uint32_t *)((uintptr_t)(port) + ((uint32_t)(pins) << 2))))
+
+static inline void Gpio_Set(GPIOA_Type *port, uint32_t pins) {
+    GPIO_DATA_MASKED(port, pins) = pins;
+}
+
+static inline void Gpio_Clear(GPIOA_Type *port, uint32_t pins) {
+    GPIO_DATA_MASKED(port, pins) = 0;
+}
+
+// Pins in 'pins' take their level from 'value'
+static inline void Gpio_Write(GPIOA_Type *port, uint32_t pins, uint32_t value) {
+    GPIO_DATA_MASKED(port, pins) = value;
+}
+
+// Levels of 'pins', every other bit reads 0
+static inline uint32_t Gpio_Read(GPIOA_Type *port, uint32_t pins) {
+    return GPIO_DATA_MASKED(port, pins);
+}
+
+// Function prototypes
+void GpioAccess_Init(void);          // First thing after SystemInit, clocks every board port
+#ifdef GPIO_BENCHMARK
+void GpioAccess_Benchmark(void);
+#endif
+
+#endif // GPIO_ACCESS_H
@@ -0,0 +1,244 @@
+#include "i2c_master.h"
+
+// The state machine below touches only the register block and the i2c_port
+// calls, never the NVIC or the kernel directly
+
+#define REGS                 I2C_MASTER_REGS
+
+// MCS write (command) bits
+#define MCS_RUN              0x01
+#define MCS_START            0x02
+#define MCS_STOP             0x04
+
+// MMIS bit of a completed master operation
+#define MMIS_MIS             0x01
+
+// MCS read (status) bits
+#define MCS_BUSY             0x01
+#define MCS_ERROR            0x02
+#define MCS_ADRACK           0x04
+#define MCS_ARBLST           0x10
+
+// Pending transactions, consumed by the ISR in FIFO order
+static I2C_Transaction_t *txnQueue[I2C1_QUEUE_LEN];
+static volatile uint8_t queueHead = 0;
+static volatile uint8_t queueCount = 0;
+
+// Transaction currently on the bus and the next byte to hand to MDR
+static I2C_Transaction_t *volatile currentTxn = NULL;
+static uint16_t txIndex = 0;
+
+void I2C1_Init(void) {
+    I2CPort_Init();
+
+    REGS->MCR = 0x10;           // Master mode
+    REGS->MTPR = 7;             // 100kHz assuming 16MHz
+
+    // Interrupt on every completed master operation
+    REGS->MICR = 1;
+    REGS->MIMR = 1;
+    I2CPort_EnableIrq(I2C1_IRQ_PRIORITY);
+}
+
+// Total bytes on the wire, including the optional register byte
+static uint16_t TxnLength(const I2C_Transaction_t *txn) {
+    return txn->len + (txn->useReg ? 1 : 0);
+}
+
+static uint8_t TxnByte(const I2C_Transaction_t *txn, uint16_t index) {
+    if (txn->useReg) {
+        if (index == 0) return txn->reg;
+        index--;
+    }
+    return txn->data[index];
+}
+
+// MCS command for byte 'index' of a 'total' byte burst
+static uint32_t TxnCommand(uint16_t index, uint16_t total) {
+    uint32_t cmd = MCS_RUN;
+    if (index == 0) cmd |= MCS_START;
+    if (index == total - 1) cmd |= MCS_STOP;
+    return cmd;
+}
+
+// Put the next byte of the current transaction on the bus
+static void I2C1_SendNext(void) {
+    REGS->MDR = TxnByte(currentTxn, txIndex);
+    REGS->MCS = TxnCommand(txIndex, TxnLength(currentTxn));
+    txIndex++;
+}
+
+// Pop the next queued transaction and start it. Caller must hold off the ISR
+// (critical section or ISR context).
+static void I2C1_StartNext(void) {
+    if (queueCount == 0) {
+        currentTxn = NULL;
+        return;
+    }
+
+    currentTxn = txnQueue[queueHead];
+    queueHead = (queueHead + 1) % I2C1_QUEUE_LEN;
+    queueCount--;
+
+    txIndex = 0;
+    REGS->MSA = currentTxn->addr << 1;
+    I2C1_SendNext();
+}
+
+// Wait until the controller is idle and drop the interrupt of the operation
+// that just ended, so it cannot advance whatever transaction starts next
+static void I2C1_WaitIdle(void) {
+    for (volatile int i = 0; i < 2000 && (REGS->MCS & MCS_BUSY); i++);
+    REGS->MICR = 1;
+    I2CPort_ClearPending();
+}
+
+static void I2C1_Complete(int8_t status, I2CPort_Woken_t *woken) {
+    I2C_Transaction_t *done = currentTxn;
+    I2CPort_Task_t notify = done->notify;
+
+    // Descriptor may be reused by its owner as soon as status is written
+    done->status = status;
+    I2C1_StartNext();
+
+    if (notify != NULL) {
+        I2CPort_NotifyFromIsr(notify, I2C1_NOTIFY_INDEX, woken);
+    }
+}
+
+void I2C1_Handler(void) {
+    I2CPort_Woken_t woken = 0;
+    uint32_t mcs;
+
+    // Already handled by an abort, or raised for an operation that is over
+    if (!(REGS->MMIS & MMIS_MIS)) return;
+    REGS->MICR = 1;
+    if (currentTxn == NULL) return;
+
+    mcs = REGS->MCS;
+    if (mcs & MCS_BUSY) return;
+    if (mcs & MCS_ERROR) {
+        // Release the bus ourselves unless arbitration was lost
+        if (!(mcs & MCS_ARBLST)) {
+            REGS->MCS = MCS_STOP;
+            I2C1_WaitIdle();
+        }
+        I2C1_Complete((mcs & MCS_ADRACK) ? I2C_ERR_ADDR : I2C_ERR_DATA, &woken);
+    } else if (txIndex < TxnLength(currentTxn)) {
+        I2C1_SendNext();
+    } else {
+        I2C1_Complete(I2C_OK, &woken);
+    }
+
+    I2CPort_YieldFromIsr(woken);
+}
+
+int I2C1_Submit(I2C_Transaction_t *txn) {
+    int result = I2C_OK;
+
+    if (txn->len == 0 && !txn->useReg) return I2C_ERR_DATA;
+
+    I2CPort_EnterCritical();
+    if (queueCount == I2C1_QUEUE_LEN) {
+        result = I2C_ERR_QUEUE;
+    } else {
+        txn->status = I2C_PENDING;
+        txnQueue[(queueHead + queueCount) % I2C1_QUEUE_LEN] = txn;
+        queueCount++;
+        if (currentTxn == NULL) {
+            I2C1_StartNext();
+        }
+    }
+    I2CPort_ExitCritical();
+
+    return result;
+}
+
+// Withdraw a transaction that did not complete in time
+static void I2C1_Abort(I2C_Transaction_t *txn) {
+    I2CPort_EnterCritical();
+    if (txn->status == I2C_PENDING) {
+        if (currentTxn == txn) {
+            // Let the byte in flight finish, STOP is only accepted when idle
+            I2C1_WaitIdle();
+            REGS->MCS = MCS_STOP;
+            I2C1_WaitIdle();
+            I2C1_StartNext();
+        } else {
+            // Still queued: close the gap it leaves in the ring
+            uint8_t kept = 0;
+            for (uint8_t i = 0; i < queueCount; i++) {
+                I2C_Transaction_t *t = txnQueue[(queueHead + i) % I2C1_QUEUE_LEN];
+                if (t != txn) {
+                    txnQueue[(queueHead + kept) % I2C1_QUEUE_LEN] = t;
+                    kept++;
+                }
+            }
+            queueCount = kept;
+        }
+        txn->status = I2C_ERR_TIMEOUT;
+    }
+    I2CPort_ExitCritical();
+}
+
+// Spin on MCS, used before the scheduler (and therefore notifications) exists
+static int I2C1_TransferPolled(I2C_Transaction_t *txn) {
+    uint16_t total = TxnLength(txn);
+    uint32_t mcs;
+
+    REGS->MSA = txn->addr << 1;
+    for (uint16_t i = 0; i < total; i++) {
+        REGS->MDR = TxnByte(txn, i);
+        REGS->MCS = TxnCommand(i, total);
+        while (REGS->MCS & MCS_BUSY);
+
+        mcs = REGS->MCS;
+        if (mcs & MCS_ERROR) {
+            if (!(mcs & MCS_ARBLST)) REGS->MCS = MCS_STOP;
+            txn->status = (mcs & MCS_ADRACK) ? I2C_ERR_ADDR : I2C_ERR_DATA;
+            return txn->status;
+        }
+    }
+
+    REGS->MICR = 1;
+    txn->status = I2C_OK;
+    return I2C_OK;
+}
+
+int I2C1_Transfer(I2C_Transaction_t *txn) {
+    int result;
+
+    if (!I2CPort_SchedulerRunning()) {
+        return I2C1_TransferPolled(txn);
+    }
+
+    txn->notify = I2CPort_CurrentTask();
+    result = I2C1_Submit(txn);
+    if (result != I2C_OK) return result;
+
+    // Sleep while the ISR streams the bytes
+    if (I2CPort_WaitNotify(I2C1_NOTIFY_INDEX, I2C1_TIMEOUT_MS) == 0) {
+        I2C1_Abort(txn);
+        if (txn->status != I2C_ERR_TIMEOUT) {
+            // Completed between the timeout and the abort, drop the late give
+            (void)I2CPort_WaitNotify(I2C1_NOTIFY_INDEX, 0);
+        }
+    }
+
+    return txn->status;
+}
+
+char I2C1_Write_Multiple(int addr, char mem_addr, int len, char *data) {
+    I2C_Transaction_t txn;
+
+    if (len <= 0) return -1;
+
+    txn.addr = (uint8_t)addr;
+    txn.useReg = 1;
+    txn.reg = (uint8_t)mem_addr;
+    txn.data = (const uint8_t *)data;
+    txn.len = (uint16_t)len;
+    txn.notify = NULL;
+
+    return (char)I2C1_Transfer(&txn);
+}
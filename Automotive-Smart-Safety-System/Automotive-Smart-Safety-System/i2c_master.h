@@ -0,0 +1,47 @@
+#ifndef I2C_MASTER_H
+#define I2C_MASTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "i2c_port.h"
+
+// Register block driven by the engine, I2C1 unless the port selects another
+// one (the host test's simulated block)
+#ifndef I2C_MASTER_REGS
+#define I2C_MASTER_REGS      I2C_PORT_REGS
+#endif
+
+// Engine configuration
+#define I2C1_QUEUE_LEN       4     // Transactions the ISR can chain back-to-back
+#define I2C1_TIMEOUT_MS      20    // Upper bound for one blocking transfer
+#define I2C1_IRQ_PRIORITY    5     // Below configMAX_SYSCALL_INTERRUPT_PRIORITY (4)
+#define I2C1_NOTIFY_INDEX    1     // Task notification slot used for completion
+
+// Transaction status codes
+#define I2C_OK               0
+#define I2C_ERR_ADDR         (-1)  // Address not acknowledged
+#define I2C_ERR_DATA         (-2)  // Data not acknowledged or arbitration lost
+#define I2C_ERR_QUEUE        (-3)  // Transaction queue full
+#define I2C_ERR_TIMEOUT      (-4)  // No completion within I2C1_TIMEOUT_MS
+#define I2C_PENDING          1     // Still queued or on the bus
+
+// Write transaction descriptor. Owned by the engine from I2C1_Submit() until
+// status leaves I2C_PENDING, so it must outlive the transfer.
+typedef struct {
+    uint8_t addr;                // 7-bit slave address
+    uint8_t useReg;              // Send reg ahead of data when non-zero
+    uint8_t reg;                 // Register / memory address byte
+    const uint8_t *data;         // Payload
+    uint16_t len;                // Payload length in bytes
+    I2CPort_Task_t notify;       // Task notified on completion (may be NULL)
+    volatile int8_t status;      // I2C_PENDING, I2C_OK or I2C_ERR_*
+} I2C_Transaction_t;
+
+// Function prototypes
+void I2C1_Init(void);
+int I2C1_Submit(I2C_Transaction_t *txn);      // Non-blocking, scheduler must be running
+int I2C1_Transfer(I2C_Transaction_t *txn);    // Blocks the caller until completion
+char I2C1_Write_Multiple(int addr, char mem_addr, int len, char *data);
+void I2C1_Handler(void);
+
+#endif // I2C_MASTER_H
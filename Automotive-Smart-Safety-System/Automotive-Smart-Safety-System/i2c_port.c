@@ -0,0 +1,16 @@
+#include "i2c_port.h"
+#include "board_pins.h"
+
+void I2CPort_Init(void) {
+    SYSCTL->RCGCI2C |= (1 << 1);   // I2C1, GPIOA is clocked by GpioAccess_Init
+    while ((SYSCTL->PRI2C & 0x02) == 0);
+
+    GPIO_CONFIG_ALT(PIN_I2C1_SCL, 0x3);   // PA6
+    GPIO_CONFIG_ALT(PIN_I2C1_SDA, 0x3);   // PA7
+    GPIO_PORT_OF(PIN_I2C1_SDA)->ODR |= GPIO_MASK_OF(PIN_I2C1_SDA);   // Open-drain
+}
+
+void I2CPort_EnableIrq(uint8_t priority) {
+    NVIC_SetPriority(I2C1_IRQn, priority);
+    NVIC_EnableIRQ(I2C1_IRQn);
+}
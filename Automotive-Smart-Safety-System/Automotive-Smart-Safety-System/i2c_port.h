@@ -0,0 +1,63 @@
+#ifndef I2C_PORT_H
+#define I2C_PORT_H
+
+#include <stdint.h>
+
+// Everything the I2C1 engine needs besides its register block: clocks, pins,
+// the interrupt and the kernel calls. i2c_master.c reaches the chip and the
+// RTOS only through this header, so a host build with I2C_HOST_TEST swaps in
+// a simulated register block and a fake kernel (test/i2c_port_host.h) and
+// runs the same state machine and ISR.
+#ifdef I2C_HOST_TEST
+#include "i2c_port_host.h"
+#else
+#include "TM4C123GH6PM.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define I2C_PORT_REGS        I2C1
+
+typedef TaskHandle_t I2CPort_Task_t;
+typedef BaseType_t I2CPort_Woken_t;
+
+// Function prototypes
+void I2CPort_Init(void);                 // Clocks and pins, before the registers are set up
+void I2CPort_EnableIrq(uint8_t priority);
+
+static inline void I2CPort_EnterCritical(void) {
+    taskENTER_CRITICAL();
+}
+
+static inline void I2CPort_ExitCritical(void) {
+    taskEXIT_CRITICAL();
+}
+
+// Notifications only work once the scheduler runs
+static inline uint8_t I2CPort_SchedulerRunning(void) {
+    return xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+}
+
+static inline I2CPort_Task_t I2CPort_CurrentTask(void) {
+    return xTaskGetCurrentTaskHandle();
+}
+
+static inline void I2CPort_NotifyFromIsr(I2CPort_Task_t task, uint8_t index, I2CPort_Woken_t *woken) {
+    vTaskNotifyGiveIndexedFromISR(task, index, woken);
+}
+
+// Drop an interrupt the controller raised while the engine was polling it
+static inline void I2CPort_ClearPending(void) {
+    NVIC_ClearPendingIRQ(I2C1_IRQn);
+}
+
+static inline void I2CPort_YieldFromIsr(I2CPort_Woken_t woken) {
+    portYIELD_FROM_ISR(woken);
+}
+
+// Returns 0 if no notification arrived within timeoutMs; 0 ms only polls
+static inline uint32_t I2CPort_WaitNotify(uint8_t index, uint32_t timeoutMs) {
+    return ulTaskNotifyTakeIndexed(index, pdTRUE, pdMS_TO_TICKS(timeoutMs));
+}
+#endif
+
+#endif // I2C_PORT_H
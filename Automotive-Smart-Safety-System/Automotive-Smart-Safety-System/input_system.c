@@ -0,0 +1,167 @@
+#include "input_system.h"
+#include "TM4C123GH6PM.h"
+#include "gpio_access.h"
+#include "trace.h"
+#include "timing_analysis.h"
+#include "stack_monitor.h"
+
+// Inputs are sampled only while something is moving: an edge interrupt masks
+// the port and wakes the sampler task, the sampler re-enables the interrupts
+// once every input has settled. The sampler is a task of its own in the
+// timing analysis, sporadic with INPUT_SAMPLE_MS between samples, so the
+// printing timer callbacks can run below every analysed task.
+
+// Debounced levels and the edges not yet taken by a consumer
+static volatile uint32_t stableInputs = 0;
+static volatile uint32_t inputEdges = 0;
+
+// Two bit vertical counter, one bit of each word per input
+static uint32_t countLow = 0;
+static uint32_t countHigh = 0;
+
+typedef struct {
+    uint32_t mask;
+    TaskHandle_t task;
+} InputSubscriber_t;
+
+static InputSubscriber_t subscribers[INPUT_MAX_SUBSCRIBERS];
+static uint8_t subscriberCount = 0;
+
+static TaskHandle_t sampleTask = NULL;
+static StackType_t sampleStack[INPUT_STACK_SIZE];
+static StaticTask_t sampleTcb;
+
+// Both ports in one word, Port F above Port B
+static uint32_t ReadInputs(void) {
+    return Gpio_Read(GPIO_PORTB, INPUT_PORTB_PINS) | (Gpio_Read(GPIO_PORTF, INPUT_PORTF_PINS) << 8);
+}
+
+static void EnableEdgeInterrupts(void) {
+    GPIO_PORTB->IM |= INPUT_PORTB_PINS;
+    GPIO_PORTF->IM |= INPUT_PORTF_PINS;
+}
+
+// One pass over every input. An input changes its stable level after four
+// consecutive samples disagree with it; any agreeing sample resets its count.
+// Returns 1 once every input has settled and the edge interrupts are back on.
+static uint8_t InputSystem_Sample(void) {
+    uint32_t raw = ReadInputs();
+    uint32_t delta = raw ^ stableInputs;
+    uint32_t toggled;
+
+    countHigh = (countHigh ^ countLow) & delta;
+    countLow = ~countLow & delta;
+    toggled = delta & ~(countLow | countHigh);
+
+    if (toggled) {
+        Trace_Record(TRACE_INPUT_EDGE, (uint16_t)toggled);
+
+        taskENTER_CRITICAL();
+        stableInputs ^= toggled;
+        inputEdges |= toggled;
+        taskEXIT_CRITICAL();
+
+        for (uint8_t i = 0; i < subscriberCount; i++) {
+            if (toggled & subscribers[i].mask) {
+                xTaskNotifyGive(subscribers[i].task);
+            }
+        }
+    }
+
+    // All settled: stop sampling and wait for the next edge. Interrupt flags
+    // are cleared before the final read so an edge in between still fires.
+    if ((countLow | countHigh) == 0) {
+        GPIO_PORTB->ICR = INPUT_PORTB_PINS;
+        GPIO_PORTF->ICR = INPUT_PORTF_PINS;
+        if (ReadInputs() == stableInputs) {
+            EnableEdgeInterrupts();
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Sleeps until an edge, then samples every INPUT_SAMPLE_MS until it settles
+static void vInputSampleTask(void *pvParameters) {
+    (void)pvParameters;
+
+    while (1) {
+        TickType_t release;
+        uint8_t settled = 0;
+
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        release = xTaskGetTickCount();
+        while (!settled) {
+            vTaskDelayUntil(&release, pdMS_TO_TICKS(INPUT_SAMPLE_MS));
+            Timing_Begin(TIMING_INPUTS);
+            settled = InputSystem_Sample();
+            Timing_End(TIMING_INPUTS);
+        }
+    }
+}
+
+// First edge on a port: hand its pins to the sampler until they settle
+static void InputSystem_EdgeFromISR(GPIOA_Type *port, uint32_t pins) {
+    BaseType_t woken = pdFALSE;
+
+    port->IM &= ~pins;
+    port->ICR = pins;
+    vTaskNotifyGiveFromISR(sampleTask, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void GPIOB_Handler(void) {
+    InputSystem_EdgeFromISR(GPIO_PORTB, INPUT_PORTB_PINS);
+}
+
+void GPIOF_Handler(void) {
+    InputSystem_EdgeFromISR(GPIO_PORTF, INPUT_PORTF_PINS);
+}
+
+void InputSystem_Init(void) {
+    // Pins already read their rest level, start from there
+    stableInputs = ReadInputs();
+
+    sampleTask = xTaskCreateStatic(vInputSampleTask, "Inputs", INPUT_STACK_SIZE, NULL,
+                                   Timing_Priority(TIMING_INPUTS), sampleStack, &sampleTcb);
+    StackMonitor_Register(sampleTask, INPUT_STACK_SIZE);
+
+    // Both edges of every watched pin
+    GPIO_PORTB->IS &= ~INPUT_PORTB_PINS;
+    GPIO_PORTB->IBE |= INPUT_PORTB_PINS;
+    GPIO_PORTF->IS &= ~INPUT_PORTF_PINS;
+    GPIO_PORTF->IBE |= INPUT_PORTF_PINS;
+    GPIO_PORTB->ICR = INPUT_PORTB_PINS;
+    GPIO_PORTF->ICR = INPUT_PORTF_PINS;
+    EnableEdgeInterrupts();
+
+    NVIC_SetPriority(GPIOB_IRQn, INPUT_IRQ_PRIORITY);
+    NVIC_SetPriority(GPIOF_IRQn, INPUT_IRQ_PRIORITY);
+    NVIC_EnableIRQ(GPIOB_IRQn);
+    NVIC_EnableIRQ(GPIOF_IRQn);
+}
+
+uint32_t InputSystem_GetStable(void) {
+    return stableInputs;
+}
+
+// Consumers own disjoint masks, so taking clears only their own edges
+uint32_t InputSystem_TakeEdges(uint32_t mask) {
+    uint32_t edges;
+
+    taskENTER_CRITICAL();
+    edges = inputEdges & mask;
+    inputEdges &= ~mask;
+    taskEXIT_CRITICAL();
+
+    return edges;
+}
+
+// Register before the scheduler starts or from the subscribing task itself
+void InputSystem_Subscribe(uint32_t mask, TaskHandle_t task) {
+    if (subscriberCount < INPUT_MAX_SUBSCRIBERS) {
+        subscribers[subscriberCount].mask = mask;
+        subscribers[subscriberCount].task = task;
+        subscriberCount++;
+    }
+}
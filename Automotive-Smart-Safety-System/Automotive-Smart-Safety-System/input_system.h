@@ -0,0 +1,30 @@
+#ifndef INPUT_SYSTEM_H
+#define INPUT_SYSTEM_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Port B and Port F inputs share one bitmask: PB0-PB7 in bits 0-7,
+// PF0-PF7 in bits 8-15
+#define INPUT_PB(pin)        (1UL << (pin))
+#define INPUT_PF(pin)        (1UL << (8 + (pin)))
+
+// Pins debounced by the sampler
+#define INPUT_PORTB_PINS     0x01    // PB0 lock button
+#define INPUT_PORTF_PINS     0x1F    // PF0/PF1 gear, PF2 door, PF3 ignition, PF4 unlock
+
+// Sampler configuration
+#define INPUT_SAMPLE_MS      2       // A level must hold for 4 samples to count
+#define INPUT_SAMPLE_BUDGET_US 30    // WCET of one sample in the timing analysis
+#define INPUT_STACK_SIZE     128     // Words
+#define INPUT_IRQ_PRIORITY   5       // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+#define INPUT_MAX_SUBSCRIBERS 4
+
+// Function prototypes
+void InputSystem_Init(void);                             // After the pins are configured and Timing_Init
+uint32_t InputSystem_GetStable(void);                    // Debounced levels
+uint32_t InputSystem_TakeEdges(uint32_t mask);           // Edges in mask since last take
+void InputSystem_Subscribe(uint32_t mask, TaskHandle_t task);  // Notified on edges in mask
+
+#endif // INPUT_SYSTEM_H
@@ -1,7 +1,20 @@
 #include "lcd.h"
-#include <stdio.h>
+#include "text_format.h"
+#include <string.h>
 
-static SemaphoreHandle_t lcdMutex = NULL;
+// Shadow of the visible cells and where the panel's address counter points.
+// Writes are compared against the shadow and only changed cells hit the bus.
+static char lcdShadow[LCD_ROWS][LCD_COLS];
+static int lcdHwAddr = -1;          // DDRAM address of the next data write, -1 unknown
+static int cursorRow = 0;           // Logical cursor set by LCD_set_cursor
+static int cursorCol = 0;
+static LCD_TrafficStats_t lcdStats;
+
+static const uint8_t rowOffsets[LCD_ROWS] = {0x00, 0x40};
+
+// Nibble stream for one LCD_write_string call: worst case is a cursor move
+// plus a character per cell, four PCF8574 bytes each
+static char lcdBurst[LCD_COLS * 8];
 
 static void delay_ms(int ms) {
     if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
@@ -11,46 +24,54 @@ static void delay_ms(int ms) {
     }
 }
 
+// Encode one byte as the four PCF8574 writes of a 4-bit transfer. The EN
+// high/low pairs are paced by the I2C bus itself (~90us per byte at 100kHz),
+// which is well above the HD44780 enable and execution timings.
+static int LCD_encode(char *out, unsigned char value, unsigned char mode) {
+    char upper = value & 0xF0;
+    char lower = (value << 4) & 0xF0;
+
+    out[0] = upper | LCD_BACKLIGHT | mode | LCD_EN;
+    out[1] = upper | LCD_BACKLIGHT | mode;
+    out[2] = lower | LCD_BACKLIGHT | mode | LCD_EN;
+    out[3] = lower | LCD_BACKLIGHT | mode;
+    return 4;
+}
+
 void LCD_command(unsigned char cmd) {
     char data[4];
-    char upper = cmd & 0xF0;
-    char lower = (cmd << 4) & 0xF0;
-
-    data[0] = upper | LCD_BACKLIGHT | LCD_EN;
-    data[1] = upper | LCD_BACKLIGHT;
-    data[2] = lower | LCD_BACKLIGHT | LCD_EN;
-    data[3] = lower | LCD_BACKLIGHT;
 
-    if (lcdMutex) xSemaphoreTake(lcdMutex, portMAX_DELAY);
-    I2C1_Write_Multiple(LCD_ADDR, 0, 4, data);
-    if (lcdMutex) xSemaphoreGive(lcdMutex);
+    LCD_encode(data, cmd, 0);
+
+    // Keep the shadow in step with commands that move or wipe the panel. A
+    // failed transfer leaves the panel state unknown, resend everything.
+    if (I2C1_Write_Multiple(LCD_ADDR, 0, 4, data) != I2C_OK) {
+        LCD_Invalidate();
+    } else if (cmd & LCD_SET_CURSOR) {
+        lcdHwAddr = cmd & 0x7F;
+        lcdStats.cursorMoves++;
+    } else if (cmd == LCD_CLEAR) {
+        memset(lcdShadow, ' ', sizeof(lcdShadow));
+        lcdHwAddr = 0;
+    } else if (cmd == LCD_HOME) {
+        lcdHwAddr = 0;
+    }
 
     delay_ms(2);
 }
 
+// Write one character at the logical cursor
 void LCD_data(unsigned char data_char) {
-    char data[4];
-    char upper = data_char & 0xF0;
-    char lower = (data_char << 4) & 0xF0;
-
-    data[0] = upper | LCD_BACKLIGHT | LCD_RS | LCD_EN;
-    data[1] = upper | LCD_BACKLIGHT | LCD_RS;
-    data[2] = lower | LCD_BACKLIGHT | LCD_RS | LCD_EN;
-    data[3] = lower | LCD_BACKLIGHT | LCD_RS;
-
-    if (lcdMutex) xSemaphoreTake(lcdMutex, portMAX_DELAY);
-    I2C1_Write_Multiple(LCD_ADDR, 0, 4, data);
-    if (lcdMutex) xSemaphoreGive(lcdMutex);
+    char str[2];
 
-    delay_ms(1);
+    str[0] = (char)data_char;
+    str[1] = '\0';
+    LCD_write_string(str);
 }
 
 void LCD_Init(void) {
     I2C1_Init();
 
-    if (lcdMutex == NULL)
-        lcdMutex = xSemaphoreCreateMutex();
-
     delay_ms(50);
 
     // Initialization sequence
@@ -80,21 +101,56 @@ void LCD_Clear(void) {
     delay_ms(2);
 }
 
+// Only records the position; the cursor command is sent lazily by LCD_data
 void LCD_set_cursor(int row, int col) {
-    const uint8_t offsets[] = {0x00, 0x40};
-    if (row > 1) row = 1;
-    LCD_command(LCD_SET_CURSOR | (col + offsets[row]));
+    if (row > LCD_ROWS - 1) row = LCD_ROWS - 1;
+    if (row < 0) row = 0;
+    if (col < 0) col = 0;
+    cursorRow = row;
+    cursorCol = col;
 }
 
-void LCD_write_string(const char *str) {
-    while (*str) {
-        LCD_data(*str++);
+// Write a string at the logical cursor as a single I2C transaction. Cells
+// that already show the character are skipped; a cursor command is inserted
+// into the stream only when the panel's address counter is not already on the
+// cell, so each changed run costs one cursor move. If the transfer fails the
+// shadow is dropped, so no cell is taken for shown that may never have arrived.
+int LCD_write_string(const char *str) {
+    int row = cursorRow;
+    int len = 0;
+    int result = I2C_OK;
+
+    for (; *str; str++) {
+        int col = cursorCol++;
+        int addr;
+
+        // Off-screen part of the DDRAM line is never visible
+        if (col >= LCD_COLS) continue;
+
+        lcdStats.cellsRequested++;
+        if (lcdShadow[row][col] == *str) continue;
+
+        addr = rowOffsets[row] + col;
+        if (lcdHwAddr != addr) {
+            len += LCD_encode(&lcdBurst[len], LCD_SET_CURSOR | addr, 0);
+            lcdStats.cursorMoves++;
+        }
+        len += LCD_encode(&lcdBurst[len], (unsigned char)*str, LCD_RS);
+        lcdHwAddr = addr + 1;
+        lcdShadow[row][col] = *str;
+        lcdStats.cellsSent++;
+    }
+
+    if (len > 0) {
+        result = (int8_t)I2C1_Write_Multiple(LCD_ADDR, 0, len, lcdBurst);
+        if (result != I2C_OK) LCD_Invalidate();
     }
+    return result;
 }
 
 void LCD_print_int(int value) {
-    char buffer[16];
-    snprintf(buffer, sizeof(buffer), "%d", value);
+    char buffer[FORMAT_INT_MAX_CHARS + 1];
+    *Format_Int(buffer, buffer + FORMAT_INT_MAX_CHARS, value) = '\0';
     LCD_write_string(buffer);
 }
 
@@ -103,45 +159,12 @@ void clear_cell(int c, int r) {
     LCD_data(' ');
 }
 
-void I2C1_Init(void) {
-    SYSCTL->RCGCGPIO |= (1 << 0);  // GPIOA
-    SYSCTL->RCGCI2C |= (1 << 1);   // I2C1
-    while ((SYSCTL->PRGPIO & 0x01) == 0);
-
-    GPIOA->AFSEL |= 0xC0;       // PA6, PA7
-    GPIOA->ODR   |= 0x80;       // PA7 open-drain
-    GPIOA->DEN   |= 0xC0;       // Digital enable
-    GPIOA->PCTL  &= ~0xFF000000;
-    GPIOA->PCTL  |= 0x33000000;
-
-    I2C1->MCR = 0x10;           // Master mode
-    I2C1->MTPR = 7;             // 100kHz assuming 16MHz
-}
-
-static int I2C_wait(void) {
-    while (I2C1->MCS & 1); // Busy
-    return (I2C1->MCS & 0x0E);
+// Force the next writes to resend every cell, e.g. after an LCD reset
+void LCD_Invalidate(void) {
+    memset(lcdShadow, 0, sizeof(lcdShadow));
+    lcdHwAddr = -1;
 }
 
-char I2C1_Write_Multiple(int addr, char mem_addr, int len, char *data) {
-    if (len <= 0) return -1;
-
-    I2C1->MSA = addr << 1;
-    I2C1->MDR = mem_addr;
-    I2C1->MCS = 3;
-
-    if (I2C_wait()) return -1;
-
-    for (int i = 0; i < len - 1; i++) {
-        I2C1->MDR = data[i];
-        I2C1->MCS = 1;
-        if (I2C_wait()) return -2;
-    }
-
-    I2C1->MDR = data[len - 1];
-    I2C1->MCS = 5;
-
-    if (I2C_wait()) return -3;
-
-    return 0;
+void LCD_GetTrafficStats(LCD_TrafficStats_t *stats) {
+    *stats = lcdStats;
 }
@@ -3,6 +3,7 @@
 
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "i2c_master.h"
 
 // LCD I2C address (0x27 is 7-bit address)
 #define LCD_ADDR         0x27
@@ -15,22 +16,33 @@
 #define LCD_FUNCTION_SET 0x28
 #define LCD_SET_CURSOR   0x80
 
+// Visible geometry (16x2)
+#define LCD_ROWS         2
+#define LCD_COLS         16
+
 // LCD Control Bits
 #define LCD_RS           0x01
 #define LCD_EN           0x04
 #define LCD_BACKLIGHT    0x08
 
+// Bus traffic counters kept by the shadow framebuffer
+typedef struct {
+    uint32_t cellsRequested;   // Visible characters written by callers
+    uint32_t cellsSent;        // Characters that actually went to the panel
+    uint32_t cursorMoves;      // Cursor commands sent
+} LCD_TrafficStats_t;
+
 // Function Prototypes
 void LCD_Init(void);
 void LCD_command(unsigned char command);
 void LCD_data(unsigned char data);
-void LCD_write_string(const char *str);
+int LCD_write_string(const char *str);   // I2C_OK or I2C_ERR_*, the shadow is reset on error
 void LCD_set_cursor(int row, int col);
 void LCD_Clear(void);
 void LCD_print_int(int value);
 void clear_cell(int c, int r);
-void I2C1_Init(void);
-char I2C1_Write_Multiple(int addr, char mem_addr, int len, char *data);
+void LCD_Invalidate(void);
+void LCD_GetTrafficStats(LCD_TrafficStats_t *stats);
 
 
 #endif // LCD_H
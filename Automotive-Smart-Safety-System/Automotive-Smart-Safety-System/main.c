@@ -9,17 +9,45 @@
 #include "Door.h"
 #include "TM4C123GH6PM.h"
 #include "ultrasonic_system.h"
+#include "input_system.h"
+#include "timing_analysis.h"
+#include "power_system.h"
+#include "stack_monitor.h"
+#include "tasks.h"
+#include "cyclic_executive.h"
+#include "text_format.h"
+#include "buzzer_system.h"
+#include "output_arbiter.h"
+#include "gpio_access.h"
 
-// Global handles
-SemaphoreHandle_t xLCDMutex;
+#ifndef CYCLIC_EXECUTIVE
 
-void vDoorLockTask(void *pvParameters);
-void vDoorOpenCloseTask(void *pvParameters);
-void vSpeedTask(void *pvParameters);
-void vDisplayTask(void *pvParameters);
-void vGearTask(void *pvParameters);
-void vUltrasonicTask(void *pvParameters);
-void vIgnitionStatusTask(void *pvParameters);
+// Task stack sizes in words
+#define DOOR_LOCK_STACK_SIZE        128
+#define DOOR_OPEN_CLOSE_STACK_SIZE  128
+#define SPEED_STACK_SIZE            128
+#define GEAR_STACK_SIZE             128
+#define DISPLAY_STACK_SIZE          128
+#define ULTRASONIC_STACK_SIZE       128
+#define IGNITION_STATUS_STACK_SIZE  128
+
+// Task stacks and control blocks, all placed by the linker so the RAM budget
+// is fixed at link time (see the image map in Listings)
+static StackType_t doorLockStack[DOOR_LOCK_STACK_SIZE];
+static StackType_t doorOpenCloseStack[DOOR_OPEN_CLOSE_STACK_SIZE];
+static StackType_t speedStack[SPEED_STACK_SIZE];
+static StackType_t gearStack[GEAR_STACK_SIZE];
+static StackType_t displayStack[DISPLAY_STACK_SIZE];
+static StackType_t ultrasonicStack[ULTRASONIC_STACK_SIZE];
+static StackType_t ignitionStatusStack[IGNITION_STATUS_STACK_SIZE];
+
+static StaticTask_t doorLockTcb;
+static StaticTask_t doorOpenCloseTcb;
+static StaticTask_t speedTcb;
+static StaticTask_t gearTcb;
+static StaticTask_t displayTcb;
+static StaticTask_t ultrasonicTcb;
+static StaticTask_t ignitionStatusTcb;
 
 // Task handles
 TaskHandle_t xDoorLockTaskHandle = NULL;
@@ -29,27 +57,74 @@ TaskHandle_t xGearTaskHandle = NULL;
 TaskHandle_t xDisplayTaskHandle = NULL;
 TaskHandle_t xUltrasonicTaskHandle = NULL;
 TaskHandle_t xIgnitionStatusTaskHandle = NULL;
+#endif
 
 int main(void) {
     // Initialize all systems
     SystemInit();
+    GpioAccess_Init();        // AHB GPIO aperture, before any port is touched
     LCD_Init();
     DoorSystem_Init();
     SpeedSystem_Init();
     GearSystem_Init();
     UltrasonicSystem_Init();  // Initialize ultrasonic system
+    BuzzerSystem_Init();      // PWM tone and cadence timer, silent until a pattern plays
+    OutputArbiter_Init();     // LEDs off, buzzer and LEDs go to the highest requester
+    
+#ifdef SPEED_BENCHMARK
+    SpeedSystem_Benchmark();  // Report float vs fixed-point cycles over ITM
+#endif
+#ifdef FORMAT_BENCHMARK
+    Format_Benchmark();       // Report snprintf vs integer formatting over ITM
+#endif
+#ifdef GPIO_BENCHMARK
+    GpioAccess_Benchmark();   // Report RMW vs masked toggles on APB and AHB over ITM
+#endif
+    
+    // Tickless idle wake timer and the periodic power report
+    Power_Init();
+    
+    // Create the display server queue, the display task owns the LCD
+    Display_Init();
+    
+    // Rate-monotonic priorities from the task periods, checked for
+    // schedulability against the WCET budgets before anything runs
+    Timing_Init();
+    
+    // Debounce the door and gear inputs configured above, the sampler task
+    // takes its priority from the timing model
+    InputSystem_Init();
+    
+#ifdef CYCLIC_EXECUTIVE
+    // One time-triggered task runs every job from the schedule table
+    CyclicExecutive_Init();
+#else
+    // Create tasks from static storage, there is no kernel heap
+    xDoorLockTaskHandle = xTaskCreateStatic(vDoorLockTask, "DoorLock", DOOR_LOCK_STACK_SIZE, NULL,
+        Timing_Priority(TIMING_DOOR_LOCK), doorLockStack, &doorLockTcb);
+    xDoorOpenCloseTaskHandle = xTaskCreateStatic(vDoorOpenCloseTask, "DoorOpenClose", DOOR_OPEN_CLOSE_STACK_SIZE, NULL,
+        Timing_Priority(TIMING_DOOR_OPEN_CLOSE), doorOpenCloseStack, &doorOpenCloseTcb);
+    xSpeedTaskHandle = xTaskCreateStatic(vSpeedTask, "Speed", SPEED_STACK_SIZE, NULL,
+        Timing_Priority(TIMING_SPEED), speedStack, &speedTcb);
+    xGearTaskHandle = xTaskCreateStatic(vGearTask, "Gear", GEAR_STACK_SIZE, NULL,
+        Timing_Priority(TIMING_GEAR), gearStack, &gearTcb);
+    xDisplayTaskHandle = xTaskCreateStatic(vDisplayTask, "Display", DISPLAY_STACK_SIZE, NULL,
+        Timing_Priority(TIMING_DISPLAY), displayStack, &displayTcb);
+    xUltrasonicTaskHandle = xTaskCreateStatic(vUltrasonicTask, "Ultrasonic", ULTRASONIC_STACK_SIZE, NULL,
+        Timing_Priority(TIMING_ULTRASONIC), ultrasonicStack, &ultrasonicTcb);
+    xIgnitionStatusTaskHandle = xTaskCreateStatic(vIgnitionStatusTask, "IgnitionStatus", IGNITION_STATUS_STACK_SIZE, NULL,
+        Timing_Priority(TIMING_IGNITION_STATUS), ignitionStatusStack, &ignitionStatusTcb);
     
-    // Create mutex for LCD access
-    xLCDMutex = xSemaphoreCreateMutex();
-    
-    // Create tasks
-    xTaskCreate(vDoorLockTask, "DoorLock", 128, NULL, 3, NULL);
-    xTaskCreate(vDoorOpenCloseTask, "DoorOpenClose", 128, NULL, 3, NULL);
-    xTaskCreate(vSpeedTask, "Speed", 128, NULL, 3, NULL);
-    xTaskCreate(vGearTask, "Gear", 128, NULL, 3, NULL);
-    xTaskCreate(vDisplayTask, "Display", 128, NULL, 2, NULL);
-    xTaskCreate(vUltrasonicTask, "Ultrasonic", 128, NULL, 3, NULL);
-    xTaskCreate(vIgnitionStatusTask, "IgnitionStatus", 128, NULL, 3, NULL);
+    // Track the stack peaks and report recommended sizes over ITM
+    StackMonitor_Register(xDoorLockTaskHandle, DOOR_LOCK_STACK_SIZE);
+    StackMonitor_Register(xDoorOpenCloseTaskHandle, DOOR_OPEN_CLOSE_STACK_SIZE);
+    StackMonitor_Register(xSpeedTaskHandle, SPEED_STACK_SIZE);
+    StackMonitor_Register(xGearTaskHandle, GEAR_STACK_SIZE);
+    StackMonitor_Register(xDisplayTaskHandle, DISPLAY_STACK_SIZE);
+    StackMonitor_Register(xUltrasonicTaskHandle, ULTRASONIC_STACK_SIZE);
+    StackMonitor_Register(xIgnitionStatusTaskHandle, IGNITION_STATUS_STACK_SIZE);
+#endif
+    StackMonitor_Init();
     
     // Start scheduler
     vTaskStartScheduler();
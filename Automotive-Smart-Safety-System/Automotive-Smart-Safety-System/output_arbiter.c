@@ -0,0 +1,131 @@
+#include "output_arbiter.h"
+#include "TM4C123GH6PM.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace.h"
+
+// Every requester keeps one standing request. A new request re-resolves all
+// outputs and only what changed reaches the hardware: one masked GPIODATA
+// store per port, and a pattern change for the buzzer.
+
+typedef struct {
+    uint8_t claims;              // Outputs this owner decides
+    uint8_t leds;                // Wanted LED levels inside the claims
+    const BuzzerPattern_t *pattern;   // Wanted pattern if the buzzer is claimed, NULL silent
+} OutputRequest_t;
+
+static OutputRequest_t requests[OUTPUT_OWNER_COUNT];
+
+// What the hardware currently shows
+static uint8_t appliedLeds = 0;
+static const BuzzerPattern_t *appliedPattern = NULL;
+static uint32_t outputWrites = 0;
+
+// One masked store, pins outside the mask keep their level
+static void WriteMasked(GPIOA_Type *port, uint32_t pins, uint32_t value) {
+    Gpio_Write(port, pins, value);
+    outputWrites++;
+}
+
+#define GREEN_PORT    GPIO_PORT_OF(PIN_GREEN_LED)
+#define YELLOW_PORT   GPIO_PORT_OF(PIN_YELLOW_LED)
+#define RED_PORT      GPIO_PORT_OF(PIN_RED_LED)
+
+// Pin levels of the LEDs in 'leds' that sit on 'port'
+static uint32_t PortLevels(GPIOA_Type *port, uint8_t leds) {
+    uint32_t levels = 0;
+
+    if (GREEN_PORT == port && (leds & OUTPUT_GREEN_LED)) levels |= GPIO_MASK_OF(PIN_GREEN_LED);
+    if (YELLOW_PORT == port && (leds & OUTPUT_YELLOW_LED)) levels |= GPIO_MASK_OF(PIN_YELLOW_LED);
+    if (RED_PORT == port && (leds & OUTPUT_RED_LED)) levels |= GPIO_MASK_OF(PIN_RED_LED);
+    return levels;
+}
+
+// Set the changed LEDs of one port with a single store
+static void ApplyPort(GPIOA_Type *port, uint8_t leds) {
+    uint32_t changed = PortLevels(port, leds ^ appliedLeds);
+
+    if (changed) {
+        WriteMasked(port, changed, PortLevels(port, leds));
+    }
+}
+
+// Highest owner first, each output taken by the first claim on it.
+// Called inside a critical section.
+static void Resolve(void) {
+    uint8_t decided = 0;
+    uint8_t leds = 0;
+    uint8_t changed = 0;
+    const BuzzerPattern_t *pattern = NULL;
+
+    for (int8_t owner = OUTPUT_OWNER_COUNT - 1; owner >= 0; owner--) {
+        const OutputRequest_t *r = &requests[owner];
+        uint8_t taken = r->claims & ~decided;
+
+        leds |= r->leds & taken & OUTPUT_LEDS;
+        if (taken & OUTPUT_BUZZER) pattern = r->pattern;
+        decided |= taken;
+    }
+
+    if (leds != appliedLeds) {
+        ApplyPort(GREEN_PORT, leds);
+        if (YELLOW_PORT != GREEN_PORT) ApplyPort(YELLOW_PORT, leds);
+        if (RED_PORT != GREEN_PORT && RED_PORT != YELLOW_PORT) ApplyPort(RED_PORT, leds);
+        appliedLeds = leds;
+        changed = 1;
+    }
+
+    if (pattern != appliedPattern) {
+        BuzzerSystem_Play(pattern);      // NULL stops it
+        outputWrites++;
+        appliedPattern = pattern;
+        changed = 1;
+    }
+
+    if (changed) {
+        Trace_Record(TRACE_OUTPUT_CHANGE, OutputArbiter_GetOutputs());
+    }
+}
+
+void OutputArbiter_Init(void) {
+    // Configure LED pins as outputs, all off. Ports are clocked by GpioAccess_Init.
+    GPIO_CONFIG(PIN_GREEN_LED);
+    GPIO_CONFIG(PIN_YELLOW_LED);
+    GPIO_CONFIG(PIN_RED_LED);
+    GPIO_CLEAR(PIN_GREEN_LED);
+    GPIO_CLEAR(PIN_YELLOW_LED);
+    GPIO_CLEAR(PIN_RED_LED);
+    appliedLeds = 0;
+}
+
+// Repeating the standing request is cheap and writes nothing
+void OutputArbiter_Request(OutputOwner_t owner, uint8_t claims, uint8_t leds,
+                           const BuzzerPattern_t *pattern) {
+    OutputRequest_t *r;
+
+    if (owner >= OUTPUT_OWNER_COUNT) return;
+    r = &requests[owner];
+    if (!(claims & OUTPUT_BUZZER)) pattern = NULL;
+    leds &= claims;
+
+    taskENTER_CRITICAL();
+    if (r->claims != claims || r->leds != leds || r->pattern != pattern) {
+        r->claims = claims;
+        r->leds = leds;
+        r->pattern = pattern;
+        Resolve();
+    }
+    taskEXIT_CRITICAL();
+}
+
+void OutputArbiter_Release(OutputOwner_t owner) {
+    OutputArbiter_Request(owner, 0, 0, NULL);
+}
+
+uint8_t OutputArbiter_GetOutputs(void) {
+    return appliedLeds | (appliedPattern != NULL ? OUTPUT_BUZZER : 0);
+}
+
+uint32_t OutputArbiter_GetWrites(void) {
+    return outputWrites;
+}
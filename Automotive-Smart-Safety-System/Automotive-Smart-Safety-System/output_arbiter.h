@@ -0,0 +1,33 @@
+#ifndef OUTPUT_ARBITER_H
+#define OUTPUT_ARBITER_H
+
+#include <stdint.h>
+#include "buzzer_system.h"
+#include "board_pins.h"
+
+// LEDs on PIN_GREEN_LED, PIN_YELLOW_LED and PIN_RED_LED
+
+// Outputs a request can claim
+#define OUTPUT_GREEN_LED    (1 << 0)
+#define OUTPUT_YELLOW_LED   (1 << 1)
+#define OUTPUT_RED_LED      (1 << 2)
+#define OUTPUT_BUZZER       (1 << 3)
+#define OUTPUT_LEDS         (OUTPUT_GREEN_LED | OUTPUT_YELLOW_LED | OUTPUT_RED_LED)
+
+// Requesters in rising priority. Every output goes to the highest requester
+// claiming it, an output nobody claims is off.
+typedef enum {
+    OUTPUT_OWNER_PARKING = 0,    // Ultrasonic distance indication
+    OUTPUT_OWNER_DOOR,           // Door open while moving
+    OUTPUT_OWNER_COUNT
+} OutputOwner_t;
+
+// Function prototypes
+void OutputArbiter_Init(void);                       // LED pins, all outputs off
+void OutputArbiter_Request(OutputOwner_t owner, uint8_t claims, uint8_t leds,
+                           const BuzzerPattern_t *pattern);   // Any task
+void OutputArbiter_Release(OutputOwner_t owner);     // Drop every claim of the owner
+uint8_t OutputArbiter_GetOutputs(void);              // Applied LEDs, OUTPUT_BUZZER while sounding
+uint32_t OutputArbiter_GetWrites(void);              // Output register writes made so far
+
+#endif // OUTPUT_ARBITER_H
@@ -0,0 +1,243 @@
+#include "power_system.h"
+#include "TM4C123GH6PM.h"
+#include "speed_system.h"
+#include "timing_analysis.h"
+#include "vehicle_state.h"
+#include <stdio.h>
+
+// Tickless idle: the kernel calls vApplicationSleep when every task is blocked
+// for at least configEXPECTED_IDLE_TIME_BEFORE_SLEEP ticks. SysTick is stopped
+// and Wide Timer 0A, a 32-bit one-shot, wakes the core when the next task is
+// due. Any other interrupt (input edge, I2C, ultrasonic) ends the sleep early.
+
+static uint8_t running = 1;                // Ignition on applied: sampling on, tasks released
+static TaskHandle_t pollingTasks[POWER_MAX_TASKS];
+static uint8_t pollingTaskCount = 0;
+static TimerHandle_t reportTimers[POWER_MAX_TIMERS];
+static uint8_t reportTimerCount = 0;
+
+static PowerStats_t stats = {0};
+static uint32_t maxIdleTicks = 0;          // Longest sleep the wake timer can time
+static StaticTimer_t reportTimerBuffer;
+static TickType_t lastReportTick = 0;
+
+static void Power_Report(TimerHandle_t timer);
+
+void Power_Init(void) {
+    // Wide Timer 0A is the wake-up timer while SysTick is stopped
+    SYSCTL->RCGCWTIMER |= (1 << 0);
+    while((SYSCTL->PRWTIMER & (1 << 0)) == 0);
+    WTIMER0->CTL = 0;
+    WTIMER0->CFG = 0x4;                  // 32-bit halves
+    WTIMER0->TAMR = 0x1;                 // One-shot, count down
+    WTIMER0->ICR = 1;
+    WTIMER0->IMR = 1;                    // Time-out interrupt wakes the core
+    NVIC_SetPriority(WTIMER0A_IRQn, POWER_WAKE_IRQ_PRIORITY);
+    NVIC_EnableIRQ(WTIMER0A_IRQn);
+
+    maxIdleTicks = 0xFFFFFFFFUL / (SystemCoreClock / configTICK_RATE_HZ);
+
+    TimerHandle_t report = xTimerCreateStatic("Power", pdMS_TO_TICKS(POWER_REPORT_MS), pdTRUE,
+                                              NULL, Power_Report, &reportTimerBuffer);
+    xTimerStart(report, 0);
+    Power_RegisterTimer(report);
+}
+
+// Flag and pending bit are cleared in vApplicationSleep, nothing left to do
+void WTIMER0A_Handler(void) {
+    WTIMER0->ICR = 1;
+}
+
+void Power_RegisterTask(TaskHandle_t task) {
+    if (pollingTaskCount < POWER_MAX_TASKS) {
+        pollingTasks[pollingTaskCount++] = task;
+    }
+}
+
+// Periodic reports and samplers would wake the core and print while the
+// tasks are parked, inflating the very wakeup rate the parked state is
+// measured by. They are stopped with the tasks and restarted on ignition on.
+void Power_RegisterTimer(TimerHandle_t timer) {
+    if (timer != NULL && reportTimerCount < POWER_MAX_TIMERS) {
+        reportTimers[reportTimerCount++] = timer;
+    }
+}
+
+static uint8_t IgnitionOn(void) {
+    VehicleState_t vehicle;
+
+    VehicleState_Read(&vehicle);
+    return vehicle.ignitionOn;
+}
+
+// Ignition off parks the polling tasks and stops the speed sampling, leaving
+// only the input edge interrupts to wake the core. Called by the door logic,
+// the one writer of the ignition state, after every update.
+void Power_Update(void) {
+    uint8_t on = IgnitionOn();
+
+    if (on == running) return;
+    running = on;
+
+    if (on) {
+        SpeedSystem_Start();
+    } else {
+        SpeedSystem_Stop();
+    }
+
+    // The timer task runs below every caller, the commands wait in its queue
+    for (uint8_t i = 0; i < reportTimerCount; i++) {
+        if (on) {
+            xTimerStart(reportTimers[i], 0);
+        } else {
+            xTimerStop(reportTimers[i], 0);
+        }
+    }
+
+    // Cut the current wait short so every task re-checks the new state. A
+    // task that is about to park finds the notification already pending.
+    for (uint8_t i = 0; i < pollingTaskCount; i++) {
+        xTaskNotifyGive(pollingTasks[i]);
+    }
+}
+
+// Absolute release of a registered task: wait for the next point of the
+// grid *release + n * period. A notification (input edge, ignition change)
+// ends the wait early without moving the grid and returns pdFALSE. After an
+// overrun the missed releases are skipped, keeping the phase. While parked the
+// task sleeps for good and the grid restarts when it is released.
+BaseType_t Power_WaitUntil(TickType_t *release, TickType_t period) {
+    TickType_t now = xTaskGetTickCount();
+    TickType_t next = *release + period;
+
+    if (!IgnitionOn()) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        *release = xTaskGetTickCount();
+        return pdFALSE;
+    }
+
+    if ((TickType_t)(now - *release) < period) {
+        if (ulTaskNotifyTake(pdTRUE, next - now) != 0) {
+            return pdFALSE;
+        }
+    } else {
+        next = now - (now - *release) % period;
+    }
+
+    *release = next;
+    return pdTRUE;
+}
+
+void Power_GetStats(PowerStats_t *out) {
+    taskENTER_CRITICAL();
+    *out = stats;
+    taskEXIT_CRITICAL();
+}
+
+void vApplicationSleep(TickType_t expectedIdleTime) {
+    uint32_t tickCycles = SystemCoreClock / configTICK_RATE_HZ;
+    uint32_t tickRemaining;
+    uint32_t sleepCycles;
+    uint32_t sinceTick;
+    uint32_t completeTicks;
+    uint32_t nextTick;
+    uint8_t timedOut;
+
+    if (expectedIdleTime > maxIdleTicks) {
+        expectedIdleTime = maxIdleTicks;
+    }
+
+    // Interrupts off before SysTick stops: a tick handled in between would
+    // advance the kernel past expectedIdleTime and the sleep would run long
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    // Stop SysTick, the cycles left in the current tick carry into the sleep
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    tickRemaining = SysTick->VAL;
+    if (tickRemaining == 0) tickRemaining = tickCycles;
+
+    // A task became ready or a context switch is pending, resume the tick
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep) {
+        SysTick->LOAD = tickRemaining - 1;
+        SysTick->VAL = 0;
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        SysTick->LOAD = tickCycles - 1;
+        __enable_irq();
+        return;
+    }
+
+    sleepCycles = tickRemaining + (expectedIdleTime - 1) * tickCycles;
+    WTIMER0->CTL = 0;
+    WTIMER0->TAILR = sleepCycles;
+    WTIMER0->ICR = 1;
+    WTIMER0->CTL = 1;
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    // Whatever woke the core is still pending, measure the sleep first
+    timedOut = (WTIMER0->RIS & 1) != 0;
+    if (!timedOut) sleepCycles -= WTIMER0->TAV;
+    sinceTick = (tickCycles - tickRemaining) + sleepCycles;
+    Timing_AddSleepCycles(sleepCycles);
+    WTIMER0->CTL = 0;
+    WTIMER0->ICR = 1;
+    NVIC_ClearPendingIRQ(WTIMER0A_IRQn);
+
+    // Whole ticks slept, and how far into the next one we already are. The
+    // final tick of a full sleep is left to SysTick so the kernel sees it.
+    completeTicks = sinceTick / tickCycles;
+    if (completeTicks >= expectedIdleTime) {
+        completeTicks = expectedIdleTime - 1;
+    }
+    nextTick = (completeTicks + 1) * tickCycles - sinceTick;
+    if (nextTick < 2) nextTick = 2;
+
+    SysTick->LOAD = nextTick - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = tickCycles - 1;
+
+    vTaskStepTick(completeTicks);
+
+    stats.wakeups++;
+    stats.sleptTicks += completeTicks;
+    if (!timedOut) {
+        stats.eventWakeups++;
+    }
+
+    __enable_irq();
+}
+
+// Wakeups per second, sleep residency and the supply current it implies,
+// since the last report. The first report after ignition on covers the whole
+// parked time, the report timer is stopped meanwhile.
+static void Power_Report(TimerHandle_t timer) {
+    static PowerStats_t last = {0};
+    PowerStats_t now;
+    TickType_t tick = xTaskGetTickCount();
+    uint32_t periodTicks = tick - lastReportTick;
+    uint32_t periodMs = periodTicks * portTICK_PERIOD_MS;
+    uint32_t residency;      // Per mille of the period spent asleep
+    uint32_t currentUa;
+
+    (void)timer;
+    Power_GetStats(&now);
+    lastReportTick = tick;
+    if (periodMs == 0) return;
+
+    residency = (uint32_t)(((uint64_t)(now.sleptTicks - last.sleptTicks) * 1000) / periodTicks);
+    if (residency > 1000) residency = 1000;
+    currentUa = POWER_RUN_UA - ((POWER_RUN_UA - POWER_SLEEP_UA) * residency) / 1000;
+
+    printf("Power: %lu wakeups/s (%lu by events), asleep %lu.%lu%%, ~%lu uA over %lu s\n",
+           (unsigned long)(((uint64_t)(now.wakeups - last.wakeups) * 1000) / periodMs),
+           (unsigned long)(((uint64_t)(now.eventWakeups - last.eventWakeups) * 1000) / periodMs),
+           (unsigned long)(residency / 10), (unsigned long)(residency % 10),
+           (unsigned long)currentUa, (unsigned long)(periodMs / 1000));
+
+    last = now;
+}
@@ -0,0 +1,35 @@
+#ifndef POWER_SYSTEM_H
+#define POWER_SYSTEM_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+// Power management configuration
+#define POWER_MAX_TASKS      6       // Polling tasks that can be parked
+#define POWER_MAX_TIMERS     4       // Report timers stopped while parked
+#define POWER_REPORT_MS      10000   // Period of the ITM power report
+#define POWER_WAKE_IRQ_PRIORITY 5    // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+
+// Supply current estimates for the report, from the TM4C123GH6PM datasheet
+// at 16 MHz with the used peripherals clocked
+#define POWER_RUN_UA         12000
+#define POWER_SLEEP_UA       5000
+
+typedef struct {
+    uint32_t wakeups;            // Exits from tickless sleep
+    uint32_t eventWakeups;       // Exits before the planned time (interrupts)
+    uint32_t sleptTicks;         // Ticks spent asleep
+} PowerStats_t;
+
+// Function prototypes
+void Power_Init(void);
+void Power_RegisterTask(TaskHandle_t task);   // From the polling task itself
+void Power_RegisterTimer(TimerHandle_t timer); // Running report timer, paused with the tasks
+void Power_Update(void);                      // Park or release the polling tasks on ignition changes
+BaseType_t Power_WaitUntil(TickType_t *release, TickType_t period);   // pdTRUE on a periodic release
+void Power_GetStats(PowerStats_t *stats);
+void vApplicationSleep(TickType_t expectedIdleTime);
+
+#endif // POWER_SYSTEM_H
@@ -1,103 +1,223 @@
 #include "speed_system.h"
 #include "TM4C123GH6PM.h"
+#include "board_pins.h"
 #include "lcd.h"
 #include "gear_system.h"
 #include "Door.h"
+#include "trace.h"
+#include "vehicle_state.h"
 #include <stdio.h>
 
-// Global variables
-static float currentSpeed = 0.0f;
-static uint32_t lastADCValue = 0;
-static uint32_t lastUpdateTime = 0;
+// Global variables, the speed itself is published in vehicle_state.c
+static uint32_t filterAcc = 0;        // Filtered ADC value scaled by 2^SPEED_FILTER_SHIFT
+static uint8_t filterPrimed = 0;
 static uint32_t minADCValue = 4095;  // Track minimum ADC value
 static uint32_t maxADCValue = 0;     // Track maximum ADC value
+static uint32_t speedScale = 0;      // Q16 MAX_SPEED / (max - min), 0 until calibrated
+
+// Sampling: Timer0A triggers SS0 which takes 8 samples of AIN0 per trigger
+#define SPEED_SAMPLE_RATE_HZ   200   // Trigger rate of the oversampled burst
+#define SPEED_FILTER_SHIFT     3     // IIR time constant of 2^3 bursts (40ms)
+#define SPEED_ADC_IRQ_PRIORITY 5     // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
 
 // Speed limits
-#define REVERSE_SPEED_LIMIT 30.0f  // 30 km/h limit in reverse
-#define MAX_SPEED 100.0f          // Maximum speed in km/h
+#define REVERSE_SPEED_LIMIT SPEED_KMH(30)  // 30 km/h limit in reverse
+#define MAX_SPEED SPEED_KMH(100)           // Maximum speed in km/h
 
 // Initialize ADC for potentiometer
 void SpeedSystem_Init(void) {
-    // Enable ADC0 and GPIOE peripherals
+    // Enable ADC0 and Timer0, GPIOE is clocked by GpioAccess_Init
     SYSCTL->RCGCADC |= (1 << 0);  // Enable ADC0
-    SYSCTL->RCGCGPIO |= (1 << 4); // Enable GPIOE
-    while((SYSCTL->PRGPIO & (1 << 4)) == 0); // Wait for GPIOE to be ready
+    SYSCTL->RCGCTIMER |= (1 << 0); // Enable Timer0
+    while((SYSCTL->PRADC & (1 << 0)) == 0);  // Wait for ADC0 to be ready
+    while((SYSCTL->PRTIMER & (1 << 0)) == 0); // Wait for Timer0 to be ready
     
     // Configure PE3 as ADC input
-    GPIOE->AFSEL |= (1 << 3);     // Enable alternate function
-    GPIOE->DEN &= ~(1 << 3);      // Disable digital function
-    GPIOE->AMSEL |= (1 << 3);     // Enable analog function
+    GPIO_CONFIG(PIN_SPEED_POT);
     
     // Configure ADC0
     ADC0->ACTSS &= ~(1 << 0);     // Disable sample sequencer 0
-    ADC0->EMUX &= ~(0xF << 0);    // Software trigger
-    ADC0->SSMUX0 = 0;             // Input channel 0 (AIN0)
-    ADC0->SSCTL0 = (1 << 1) |     // End of sequence
-                   (1 << 2);       // Interrupt enable
+    ADC0->EMUX = (ADC0->EMUX & ~(0xF << 0)) | (0x5 << 0); // Timer trigger
+    ADC0->SSMUX0 = 0;             // All 8 steps sample AIN0
+    ADC0->SSCTL0 = (1 << 29) |    // End of sequence after step 7
+                   (1 << 30);     // Interrupt on step 7
+    ADC0->ISC = (1 << 0);         // Clear stale interrupt
+    ADC0->IM |= (1 << 0);         // Unmask SS0 interrupt
+    NVIC_SetPriority(ADC0SS0_IRQn, SPEED_ADC_IRQ_PRIORITY);
+    NVIC_EnableIRQ(ADC0SS0_IRQn);
     ADC0->ACTSS |= (1 << 0);      // Enable sample sequencer 0
+    
+    // Configure Timer0A as a periodic ADC trigger
+    TIMER0->CTL = 0;              // Disable during setup
+    TIMER0->CFG = 0;              // 32-bit timer
+    TIMER0->TAMR = 0x2;           // Periodic mode
+    TIMER0->TAILR = SystemCoreClock / SPEED_SAMPLE_RATE_HZ - 1;
+    TIMER0->CTL = (1 << 5) |      // TAOTE: trigger the ADC on timeout
+                  (1 << 0);       // TAEN: start
+}
+
+// Resume sampling when the ignition comes on
+void SpeedSystem_Start(void) {
+    filterPrimed = 0;             // Start the filter from the next burst
+    TIMER0->CTL |= (1 << 0);
+}
+
+// Stop the 200 Hz ADC trigger while the ignition is off, speed reads 0
+void SpeedSystem_Stop(void) {
+    TIMER0->CTL &= ~(1 << 0);
+    VehicleState_SetSpeed(0);
+}
+
+// Recompute the Q16 scale factor after the calibration range changes, so the
+// per-sample path is a multiply and a shift instead of a division
+static void UpdateSpeedScale(void) {
+    uint32_t range = maxADCValue - minADCValue;
+    
+    if (maxADCValue > minADCValue) {
+        speedScale = (uint32_t)((((uint64_t)MAX_SPEED << 16) + range / 2) / range);
+    } else {
+        speedScale = 0;
+    }
 }
 
 // Calculate speed based on potentiometer value
-static float CalculateSpeed(uint32_t adcValue) {
-    float speed;
+static Speed_t CalculateSpeed(uint32_t adcValue, const VehicleState_t *vehicle) {
+    Speed_t speed;
+    Gear_t gear;
     
     // If ignition is off, force speed to 0
-    if (!DoorSystem_IsIgnitionOn()) {
-        return 0.0f;
+    if (!vehicle->ignitionOn) {
+        return 0;
     }
     
     // Update min/max ADC values
+    if (adcValue < minADCValue) {
+        minADCValue = adcValue;
+        UpdateSpeedScale();
+    }
+    if (adcValue > maxADCValue) {
+        maxADCValue = adcValue;
+        UpdateSpeedScale();
+    }
+    
+    // Map the ADC value to speed using the actual range of the potentiometer
+    speed = (Speed_t)(((uint64_t)(adcValue - minADCValue) * speedScale) >> 16);
+    
+    gear = vehicle->gear;
+    
+    // Apply speed limit if in reverse gear
+    if (gear == GEAR_REVERSE && speed > REVERSE_SPEED_LIMIT) {
+        speed = REVERSE_SPEED_LIMIT;
+    }
+    
+    // Force speed to 0 if in PARK gear
+    if (gear == GEAR_PARK) {
+        speed = 0;
+    }
+    
+    return speed;
+}
+
+// SS0 interrupt: drain the oversampled burst, filter it and update the speed
+void ADC0SS0_Handler(void) {
+    uint32_t sum = 0;
+    uint32_t count = 0;
+    VehicleState_t vehicle;
+    
+    ADC0->ISC = (1 << 0);         // Clear interrupt
+    
+    // Read every sample of the burst until the FIFO reports empty
+    while((ADC0->SSFSTAT0 & (1 << 8)) == 0) {
+        sum += ADC0->SSFIFO0 & 0xFFF;
+        count++;
+    }
+    if (count == 0) return;
+    
+    // First-order IIR on the burst average
+    if (!filterPrimed) {
+        filterAcc = (sum / count) << SPEED_FILTER_SHIFT;
+        filterPrimed = 1;
+    } else {
+        filterAcc = filterAcc - (filterAcc >> SPEED_FILTER_SHIFT) + sum / count;
+    }
+    
+    Trace_Record(TRACE_ADC_SAMPLE, (uint16_t)(filterAcc >> SPEED_FILTER_SHIFT));
+    
+    // Calculate speed
+    VehicleState_Read(&vehicle);
+    VehicleState_SetSpeed(CalculateSpeed(filterAcc >> SPEED_FILTER_SHIFT, &vehicle));
+}
+
+#ifdef SPEED_BENCHMARK
+// Previous float implementation, kept only as the benchmark reference
+static float CalculateSpeedFloat(uint32_t adcValue, const VehicleState_t *vehicle) {
+    float speed;
+    
+    if (!vehicle->ignitionOn) {
+        return 0.0f;
+    }
+    
     if (adcValue < minADCValue) minADCValue = adcValue;
     if (adcValue > maxADCValue) maxADCValue = adcValue;
     
-    // Calculate speed using the actual range of the potentiometer
     if (maxADCValue > minADCValue) {
-        // Map the ADC value to speed using the actual range
-        speed = ((float)(adcValue - minADCValue) * MAX_SPEED) / (maxADCValue - minADCValue);
+        speed = ((float)(adcValue - minADCValue) * 100.0f) / (maxADCValue - minADCValue);
     } else {
         speed = 0.0f;
     }
     
-    // Apply speed limit if in reverse gear
-    if (GearSystem_GetCurrentGear() == GEAR_REVERSE && speed > REVERSE_SPEED_LIMIT) {
-        speed = REVERSE_SPEED_LIMIT;
+    if (vehicle->gear == GEAR_REVERSE && speed > 30.0f) {
+        speed = 30.0f;
     }
-    
-    // Force speed to 0 if in PARK gear
-    if (GearSystem_GetCurrentGear() == GEAR_PARK) {
+    if (vehicle->gear == GEAR_PARK) {
         speed = 0.0f;
     }
     
     return speed;
 }
 
-// Update speed reading and display
-void SpeedSystem_Update(void) {
-    uint32_t adcValue;
-    
-    // If ignition is off, keep speed at 0
-    if (!DoorSystem_IsIgnitionOn()) {
-        currentSpeed = 0.0f;
-        return;
-    }
+// Compare DWT cycles per sample of the float and fixed-point paths over a
+// full ADC sweep. Run before the scheduler starts; calibration is restored.
+void SpeedSystem_Benchmark(void) {
+    uint32_t savedMin = minADCValue;
+    uint32_t savedMax = maxADCValue;
+    uint32_t savedScale = speedScale;
+    volatile float sinkFloat = 0.0f;
+    volatile Speed_t sinkFixed = 0;
+    uint32_t start;
+    uint32_t floatCycles;
+    uint32_t fixedCycles;
+    VehicleState_t vehicle;
     
-    // Trigger ADC conversion
-    ADC0->PSSI |= (1 << 0);       // Start conversion on sequencer 0
+    VehicleState_Read(&vehicle);
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
     
-    // Wait for conversion to complete
-    while((ADC0->RIS & (1 << 0)) == 0);
+    minADCValue = 0;
+    maxADCValue = 4095;
+    start = DWT->CYCCNT;
+    for (uint32_t adc = 0; adc < 4096; adc++) {
+        sinkFloat = CalculateSpeedFloat(adc, &vehicle);
+    }
+    floatCycles = DWT->CYCCNT - start;
     
-    // Read ADC value
-    adcValue = ADC0->SSFIFO0;
+    minADCValue = 0;
+    maxADCValue = 4095;
+    UpdateSpeedScale();
+    start = DWT->CYCCNT;
+    for (uint32_t adc = 0; adc < 4096; adc++) {
+        sinkFixed = CalculateSpeed(adc, &vehicle);
+    }
+    fixedCycles = DWT->CYCCNT - start;
     
-    // Clear interrupt
-    ADC0->ISC = (1 << 0);
+    minADCValue = savedMin;
+    maxADCValue = savedMax;
+    speedScale = savedScale;
+    (void)sinkFloat;
+    (void)sinkFixed;
     
-    // Calculate speed
-    currentSpeed = CalculateSpeed(adcValue);
+    printf("Speed benchmark (cycles/sample): float=%lu fixed=%lu\n",
+           (unsigned long)(floatCycles / 4096), (unsigned long)(fixedCycles / 4096));
 }
-
-// Get current speed
-float SpeedSystem_GetCurrentSpeed(void) {
-    return currentSpeed;
-} 
\ No newline at end of file
+#endif 
\ No newline at end of file
@@ -10,13 +10,18 @@
 // Speed threshold for auto-lock (in km/h)
 #define SPEED_THRESHOLD 10
 
+// Speeds are unsigned Q24.8 fixed point in km/h
+typedef uint32_t Speed_t;
+#define SPEED_FRAC_BITS     8
+#define SPEED_KMH(kmh)      ((Speed_t)(kmh) << SPEED_FRAC_BITS)
+#define SPEED_TO_TENTHS(s)  ((int32_t)(((s) * 10) >> SPEED_FRAC_BITS))
+
 // Function declarations
 void SpeedSystem_Init(void);
-void SpeedSystem_Update(void);
-float SpeedSystem_GetCurrentSpeed(void);
-
-// External declarations
-extern QueueHandle_t xDisplayQueue;
-extern SemaphoreHandle_t xLCDMutex;
+void SpeedSystem_Start(void);
+void SpeedSystem_Stop(void);
+#ifdef SPEED_BENCHMARK
+void SpeedSystem_Benchmark(void);
+#endif
 
 #endif // SPEED_SYSTEM_H 
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "stack_monitor.h"
+#include "TM4C123GH6PM.h"
+#include "timers.h"
+#include "power_system.h"
+#include <stdio.h>
+
+// Stack supervisor: samples the high-water mark of every registered task from
+// a software timer, keeps the peak use and reports a recommended size with
+// STACK_MARGIN_PERCENT headroom.
+
+typedef struct {
+    TaskHandle_t task;
+    uint32_t stackWords;
+    uint32_t peakWords;          // Most words ever used
+    uint8_t warned;              // Peak passed STACK_WARN_PERCENT, reported
+} StackRecord_t;
+
+static StackRecord_t records[STACK_MONITOR_MAX_TASKS];
+static uint8_t recordCount = 0;
+
+static StaticTimer_t sampleTimerBuffer;
+
+// Name of the task caught by the overflow check, kept for the debugger
+static volatile char overflowTaskName[configMAX_TASK_NAME_LEN];
+static volatile uint8_t overflowCaught = 0;
+
+static void StackMonitor_Tick(TimerHandle_t timer) {
+    static uint32_t elapsedMs = 0;
+    static uint8_t timerTaskRegistered = 0;
+
+    (void)timer;
+
+    // Callbacks run in the timer task and some of them print, watch it too
+    if (!timerTaskRegistered) {
+        StackMonitor_Register(xTaskGetCurrentTaskHandle(), configTIMER_TASK_STACK_DEPTH);
+        timerTaskRegistered = 1;
+    }
+
+    StackMonitor_Sample();
+
+    elapsedMs += STACK_SAMPLE_MS;
+    if (elapsedMs >= STACK_REPORT_MS) {
+        elapsedMs = 0;
+        StackMonitor_Report();
+    }
+}
+
+void StackMonitor_Init(void) {
+    TimerHandle_t sample = xTimerCreateStatic("Stacks", pdMS_TO_TICKS(STACK_SAMPLE_MS), pdTRUE,
+                                              NULL, StackMonitor_Tick, &sampleTimerBuffer);
+    xTimerStart(sample, 0);
+    Power_RegisterTimer(sample);       // Paused while the ignition is off
+}
+
+void StackMonitor_Register(TaskHandle_t task, uint32_t stackWords) {
+    if (task == NULL || recordCount >= STACK_MONITOR_MAX_TASKS) return;
+
+    records[recordCount].task = task;
+    records[recordCount].stackWords = stackWords;
+    records[recordCount].peakWords = 0;
+    records[recordCount].warned = 0;
+    recordCount++;
+}
+
+// Peak plus margin, rounded up to 8 words to keep the stack 8-byte aligned
+uint32_t StackMonitor_Recommend(uint32_t peakWords) {
+    uint32_t words = peakWords + (peakWords * STACK_MARGIN_PERCENT + 99) / 100;
+
+    if (words < STACK_MIN_WORDS) words = STACK_MIN_WORDS;
+    return (words + 7) & ~7UL;
+}
+
+static void ReportRecord(const StackRecord_t *r) {
+    printf("Stack %-15s size %3lu, peak %3lu (%lu%%), recommend %3lu words\n",
+           pcTaskGetName(r->task), (unsigned long)r->stackWords,
+           (unsigned long)r->peakWords,
+           (unsigned long)(r->peakWords * 100 / r->stackWords),
+           (unsigned long)StackMonitor_Recommend(r->peakWords));
+}
+
+void StackMonitor_Sample(void) {
+    for (uint8_t i = 0; i < recordCount; i++) {
+        StackRecord_t *r = &records[i];
+        uint32_t used = r->stackWords - uxTaskGetStackHighWaterMark(r->task);
+
+        if (used > r->peakWords) {
+            r->peakWords = used;
+            if (!r->warned && used * 100 > r->stackWords * STACK_WARN_PERCENT) {
+                r->warned = 1;
+                ReportRecord(r);
+            }
+        }
+    }
+}
+
+void StackMonitor_Report(void) {
+    for (uint8_t i = 0; i < recordCount; i++) {
+        ReportRecord(&records[i]);
+    }
+}
+
+const char *StackMonitor_GetOverflowTask(void) {
+    return overflowCaught ? (const char *)overflowTaskName : NULL;
+}
+
+// configCHECK_FOR_STACK_OVERFLOW is 2: the kernel found the guard pattern at
+// the end of a stack overwritten on a context switch. The stack can no longer
+// be trusted, so record the name, send it straight to ITM and halt.
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
+    const char *prefix = "Stack overflow: ";
+
+    (void)xTask;
+    taskDISABLE_INTERRUPTS();
+
+    for (uint8_t i = 0; i < configMAX_TASK_NAME_LEN; i++) {
+        overflowTaskName[i] = pcTaskName[i];
+        if (pcTaskName[i] == '\0') break;
+    }
+    overflowTaskName[configMAX_TASK_NAME_LEN - 1] = '\0';
+    overflowCaught = 1;
+
+    while (*prefix) ITM_SendChar(*prefix++);
+    for (uint8_t i = 0; overflowTaskName[i] != '\0'; i++) ITM_SendChar(overflowTaskName[i]);
+    ITM_SendChar('\n');
+
+    while (1);
+}
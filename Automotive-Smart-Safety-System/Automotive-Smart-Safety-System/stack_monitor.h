@@ -0,0 +1,24 @@
+#ifndef STACK_MONITOR_H
+#define STACK_MONITOR_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Stack monitor configuration
+#define STACK_MONITOR_MAX_TASKS   10
+#define STACK_SAMPLE_MS           1000    // High-water sampling period
+#define STACK_REPORT_MS           60000   // Period of the sizing report
+#define STACK_WARN_PERCENT        80      // Report at once when a peak passes this
+#define STACK_MARGIN_PERCENT      25      // Headroom added to the peak
+#define STACK_MIN_WORDS           64      // Room for an exception frame with FPU state
+
+// Function prototypes
+void StackMonitor_Init(void);                                  // Before the scheduler starts
+void StackMonitor_Register(TaskHandle_t task, uint32_t stackWords);
+void StackMonitor_Sample(void);
+void StackMonitor_Report(void);                                // Recommended size per task
+uint32_t StackMonitor_Recommend(uint32_t peakWords);
+const char *StackMonitor_GetOverflowTask(void);                // NULL if no overflow was caught
+
+#endif // STACK_MONITOR_H
@@ -8,372 +8,365 @@
 #include "display.h"
 #include "Door.h"
 #include "TM4C123GH6PM.h"
-#include <stdio.h>
 #include "ultrasonic_system.h"
+#include "timing_analysis.h"
+#include "power_system.h"
+#include "input_system.h"
+#include "trace.h"
+#include "tasks.h"
+#include "vehicle_state.h"
+#include "output_arbiter.h"
 
-// Buzzer pin definitions (update to PE5)
-#define BUZZER_PORT GPIOE
-#define BUZZER_PIN 5
-
-// Door Lock Task - Handles door locking/unlocking logic
-void vDoorLockTask(void *pvParameters) {
-    LCD_Message_t displayMsg;
+// Door lock job - Handles door locking/unlocking logic
+uint8_t Tasks_DoorLockStep(void) {
     DoorState_t currentDoorState = DOORS_UNLOCKED;
     static DoorState_t lastDoorState = DOORS_UNLOCKED;
-    static uint32_t statusDisplayTime = 0;
-    static uint8_t showingStatus = 0;
+    VehicleState_t vehicle;
+    uint8_t changed;
     
-    while(1) {
-        // Check for door state changes
-        if(DoorSystem_Update()) {  // Only update if state changed
-            uint32_t currentTime = xTaskGetTickCount();
-            
-            // Get current state
-            currentDoorState = DoorSystem_GetState();
-            
-            xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-            LCD_set_cursor(0, 0);
-            
-            // Check if lock state changed
-            if (currentDoorState != lastDoorState) {
-                if (currentDoorState == DOORS_LOCKED) {
-                    snprintf(displayMsg.line1, sizeof(displayMsg.line1), "Door: Locked  ");
-                } else {
-                    snprintf(displayMsg.line1, sizeof(displayMsg.line1), "Door: Unlocked");
-                }
-                showingStatus = 1;
-                statusDisplayTime = currentTime;
-            }
-            // If showing status message and 2 seconds have passed, return to normal display
-            else if (showingStatus && (currentTime - statusDisplayTime > pdMS_TO_TICKS(2000))) {
-                snprintf(displayMsg.line1, sizeof(displayMsg.line1), "Door: %s", 
-                        (currentDoorState == DOORS_UNLOCKED) ? "Unlocked" : "Locked  ");
-                showingStatus = 0;
-            }
-            
-            LCD_write_string(displayMsg.line1);
-            xSemaphoreGive(xLCDMutex);
-            
-            // Update last state
-            lastDoorState = currentDoorState;
+    // Check for door state changes, then look at the result
+    changed = DoorSystem_Update();
+    VehicleState_Read(&vehicle);
+    if(changed) {  // Only update if state changed
+        // Get current state
+        currentDoorState = vehicle.doorLock;
+        
+        // Lock state is the base layer of line 1, the server reads it from
+        // the vehicle state
+        if (currentDoorState != lastDoorState) {
+            Display_Notify();
         }
         
-        // Small delay for debouncing and task switching
-        vTaskDelay(pdMS_TO_TICKS(100)); // 100ms delay
+        // Update last state
+        lastDoorState = currentDoorState;
     }
+    
+    // Ignition off parks the polling tasks
+    Power_Update();
+    
+    return changed;
 }
 
-// Door Open/Close Task - Handles door open/closed state
-void vDoorOpenCloseTask(void *pvParameters) {
-    LCD_Message_t displayMsg;
+// Door Lock Task - Runs the door lock job whenever its inputs change
+void vDoorLockTask(void *pvParameters) {
+    // Input edges, debounce expiries and speed/gear changes wake this task
+    DoorSystem_SetTask(xTaskGetCurrentTaskHandle());
+    
+    while(1) {
+        uint8_t changed;
+        
+        Timing_Begin(TIMING_DOOR_LOCK);
+        changed = Tasks_DoorLockStep();
+        Timing_End(TIMING_DOOR_LOCK);
+        
+        // Sleep until something the door logic depends on changes. After a
+        // change run again at once, more input edges may still be pending.
+        if (!changed) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+}
+
+// Door open/close job - Handles door open/closed state
+void Tasks_DoorOpenCloseStep(void) {
     DoorOpenState_t currentDoorOpenState = DOOR_CLOSED;
     static DoorOpenState_t lastDoorOpenState = DOOR_CLOSED;
-    static uint32_t statusDisplayTime = 0;
-    static uint8_t showingStatus = 0;
+    static uint8_t lastWarning = 0;
+    uint8_t warning;
+    VehicleState_t vehicle;
     
-    // Enable GPIOE for buzzer
-    SYSCTL->RCGCGPIO |= (1 << 4); // Enable clock for Port E
-    while((SYSCTL->PRGPIO & (1 << 4)) == 0); // Wait for Port E ready
-    // Configure PE1 as output for buzzer
-    GPIOE->DIR |= (1 << 1);
-    GPIOE->DEN |= (1 << 1);
-    GPIOE->DATA &= ~(1 << 1); // Buzzer off initially
+    // Get current door open state and speed
+    VehicleState_Read(&vehicle);
+    currentDoorOpenState = vehicle.doorOpen;
+    Speed_t currentSpeed = vehicle.speed;
     
-    while(1) {
-        // Get current door open state and speed
-        currentDoorOpenState = DoorSystem_GetOpenState();
-        float currentSpeed = SpeedSystem_GetCurrentSpeed();
+    warning = (currentDoorOpenState == DOOR_OPEN && currentSpeed > 0);
+    
+    // The server shows the door message and the warning from the vehicle
+    // state, wake it when either changes
+    if (currentDoorOpenState != lastDoorOpenState || warning != lastWarning) {
+        Display_Notify();
         
-        // Check if door open state changed
-        if (currentDoorOpenState != lastDoorOpenState) {
-            uint32_t currentTime = xTaskGetTickCount();
-            
-            xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-            LCD_set_cursor(0, 0);
-            
-            if (currentDoorOpenState == DOOR_OPEN) {
-                snprintf(displayMsg.line1, sizeof(displayMsg.line1), "Door: Opened  ");
-            } else {
-                snprintf(displayMsg.line1, sizeof(displayMsg.line1), "Door: Closed  ");
-            }
-            
-            LCD_write_string(displayMsg.line1);
-            xSemaphoreGive(xLCDMutex);
-            
-            showingStatus = 1;
-            statusDisplayTime = currentTime;
-            
-            // Update last state
-            lastDoorOpenState = currentDoorOpenState;
-        }
-        // If showing status message and 2 seconds have passed, return to normal display
-        else if (showingStatus && (xTaskGetTickCount() - statusDisplayTime > pdMS_TO_TICKS(2000))) {
-            xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-            LCD_set_cursor(0, 0);
-            snprintf(displayMsg.line1, sizeof(displayMsg.line1), "Door: %s", 
-                    (DoorSystem_GetState() == DOORS_UNLOCKED) ? "Unlocked" : "Locked  ");
-            LCD_write_string(displayMsg.line1);
-            xSemaphoreGive(xLCDMutex);
-            
-            showingStatus = 0;
-        }
+        // Update last state
+        lastDoorOpenState = currentDoorOpenState;
+        lastWarning = warning;
+    }
+    
+    // Handle buzzer for door open while moving
+    if (warning) {
+        // Continuous buzzer for door open warning, outranks the parking beeps
+        OutputArbiter_Request(OUTPUT_OWNER_DOOR, OUTPUT_BUZZER, 0, &BUZZER_DOOR_OPEN);
+    } else {
+        OutputArbiter_Release(OUTPUT_OWNER_DOOR); // Buzzer back to the parking sensor
+    }
+}
+
+// Door Open/Close Task - Runs the door open/close job
+void vDoorOpenCloseTask(void *pvParameters) {
+    // Woken as soon as the door opens or closes
+    DoorSystem_SetOpenStateTask(xTaskGetCurrentTaskHandle());
+    Power_RegisterTask(xTaskGetCurrentTaskHandle());
+    TickType_t release = xTaskGetTickCount();
+    
+    while(1) {
+        Timing_Begin(TIMING_DOOR_OPEN_CLOSE);
+        Tasks_DoorOpenCloseStep();
+        Timing_End(TIMING_DOOR_OPEN_CLOSE);
         
-        // Handle buzzer for door open while moving
-        if (currentDoorOpenState == DOOR_OPEN && currentSpeed > 0.0f) {
-            // Continuous buzzer for door open warning
-            GPIOE->DATA |= (1 << 1); // Buzzer ON continuously
-            
-            xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-            LCD_set_cursor(1, 0);
-            snprintf(displayMsg.line2, sizeof(displayMsg.line2), "WARNING: Door Open! ");
-            LCD_write_string(displayMsg.line2);
-            xSemaphoreGive(xLCDMutex);
-        } else {
-            GPIOE->DATA &= ~(1 << 1); // Buzzer OFF
-            // Restore speed display if not in reverse
-            if (GearSystem_GetCurrentGear() != GEAR_REVERSE) {
-                xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-                LCD_set_cursor(1, 0);
-                snprintf(displayMsg.line2, sizeof(displayMsg.line2), "Speed=%.1f km/h  ", currentSpeed);
-                LCD_write_string(displayMsg.line2);
-                xSemaphoreGive(xLCDMutex);
-            }
+        // Door changes wake the task early, the periodic release picks up speed
+        // changes (none while parked, the car cannot move with the ignition off)
+        if (Power_WaitUntil(&release, pdMS_TO_TICKS(Timing_PeriodMs(TIMING_DOOR_OPEN_CLOSE)))) {
+            Timing_Release(TIMING_DOOR_OPEN_CLOSE, release);
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(100)); // 100ms delay
     }
 }
 
-// Ultrasonic Task - Handles distance measurement and display
-void vUltrasonicTask(void *pvParameters) {
-    LCD_Message_t displayMsg;
+// Ranging hardware, indicators off until the first reading
+void Tasks_InitUltrasonic(void) {
+    UltrasonicSystem_Init();
+    
+    // Turn off all indicators at start
+    UltrasonicSystem_TurnOffIndicators();
+}
+
+// Ultrasonic job - Handles distance measurement and display
+uint8_t Tasks_UltrasonicStep(uint8_t resultReady) {
     float distance = 0.0f;
     static uint32_t lastBeepTime = 0;
     static uint8_t isInReverse = 0;
     static Gear_t lastGear = GEAR_PARK;
+    VehicleState_t vehicle;
     
-    // Initialize ultrasonic system
-    UltrasonicSystem_Init();
+    VehicleState_Read(&vehicle);
+    Gear_t currentGear = vehicle.gear;
     
-    // Turn off all indicators at start
-    UltrasonicSystem_TurnOffLEDs();
-    UltrasonicSystem_TurnOffBuzzer();
+    // Check for gear change
+    if (currentGear != lastGear) {
+        // Reset states on gear change
+        isInReverse = 0;
+        lastBeepTime = 0;
+        UltrasonicSystem_TurnOffIndicators();
+        Display_Post(DISPLAY_FIELD_DISTANCE, DISPLAY_CLEAR);
+    }
     
-    while(1) {
-        Gear_t currentGear = GearSystem_GetCurrentGear();
+    // Starts ranging in reverse, stops it otherwise
+    UltrasonicSystem_Update(currentGear == GEAR_REVERSE);
+    
+    if (currentGear == GEAR_REVERSE && resultReady) {
+        distance = UltrasonicSystem_GetDistance();
         
-        // Check for gear change
-        if (currentGear != lastGear) {
-            // Reset states on gear change
-            isInReverse = 0;
-            lastBeepTime = 0;
-            UltrasonicSystem_TurnOffLEDs();
-            UltrasonicSystem_TurnOffBuzzer();
+        // Update display based on distance
+        if (distance < 150.0f && distance > 0.0f) {  // Only show distance if it's valid
+            // Show distance if less than max
+            Display_Post(DISPLAY_FIELD_DISTANCE, (int32_t)(distance * 10.0f));
+            // Update LEDs and buzzer only when distance is less than 150cm
+            UltrasonicSystem_UpdateIndicators(distance);
+        } else {
+            // Fall back to the speed layer at max distance or invalid reading
+            Display_Post(DISPLAY_FIELD_DISTANCE, DISPLAY_CLEAR);
+            // Turn off LEDs and buzzer when at max distance
+            UltrasonicSystem_TurnOffIndicators();
         }
+    } else if (currentGear != GEAR_REVERSE) {
+        // Not in reverse, turn off all indicators
+        UltrasonicSystem_TurnOffIndicators();
+    }
+    
+    isInReverse = (currentGear == GEAR_REVERSE);
+    lastGear = currentGear;
+    return isInReverse;
+}
+
+// Ultrasonic Task - Runs the ultrasonic job on every measurement
+void vUltrasonicTask(void *pvParameters) {
+    uint8_t resultReady = 0;
+    
+    // Initialize ultrasonic system, results arrive as task notifications
+    Tasks_InitUltrasonic();
+    UltrasonicSystem_SetConsumer(xTaskGetCurrentTaskHandle());
+    Power_RegisterTask(xTaskGetCurrentTaskHandle());
+    TickType_t release = xTaskGetTickCount();
+    
+    while(1) {
+        uint8_t isInReverse;
         
-        if (currentGear == GEAR_REVERSE) {
-            // Update and get distance measurement
-            UltrasonicSystem_Update();  // This updates the distance measurement
-            distance = UltrasonicSystem_GetDistance();
-            
-            // Update display based on distance
-            xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-            LCD_set_cursor(1, 0);
-            if (distance < 150.0f && distance > 0.0f) {  // Only show distance if it's valid
-                // Show distance if less than max
-                snprintf(displayMsg.line2, sizeof(displayMsg.line2), "Dist=%.1f cm  ", distance);
-                // Update LEDs and buzzer only when distance is less than 150cm
-                UltrasonicSystem_UpdateLEDs(distance);
-                UltrasonicSystem_UpdateBuzzer(distance);
-            } else {
-                // Show speed if at max distance or invalid reading
-                float currentSpeed = SpeedSystem_GetCurrentSpeed();
-                snprintf(displayMsg.line2, sizeof(displayMsg.line2), "Speed=%.1f km/h  ", currentSpeed);
-                // Turn off LEDs and buzzer when at max distance
-                UltrasonicSystem_TurnOffLEDs();
-                UltrasonicSystem_TurnOffBuzzer();
-            }
-            LCD_write_string(displayMsg.line2);
-            xSemaphoreGive(xLCDMutex);
-            
-            isInReverse = 1;
+        Timing_Begin(TIMING_ULTRASONIC);
+        isInReverse = Tasks_UltrasonicStep(resultReady);
+        Timing_End(TIMING_ULTRASONIC);
+        
+        if (isInReverse) {
+            // Sleep until the ranging interrupts deliver a measurement. The
+            // timeout only bounds how late a gear change is noticed.
+            resultReady = (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ULTRASONIC_GEAR_POLL_MS)) != 0);
+            release = xTaskGetTickCount();
         } else {
-            // Not in reverse, turn off all indicators
-            UltrasonicSystem_TurnOffLEDs();
-            UltrasonicSystem_TurnOffBuzzer();
-            isInReverse = 0;
+            // Poll the gear, parked while ignition is off. Jobs never come
+            // closer than the ranging period the timing model assumes.
+            resultReady = 0;
+            Power_WaitUntil(&release, pdMS_TO_TICKS(ULTRASONIC_GEAR_POLL_MS));
         }
-        
-        lastGear = currentGear;
-        vTaskDelay(pdMS_TO_TICKS(100)); // 100ms delay
     }
 }
 
-// Speed Task - Monitors vehicle speed and controls auto-lock
+// Speed job - Monitors vehicle speed and controls auto-lock
+void Tasks_SpeedStep(void) {
+    Speed_t currentSpeed = 0;
+    static Speed_t lastSpeed = 0;
+    static int32_t lastShownSpeed = DISPLAY_CLEAR;
+    VehicleState_t vehicle;
+    
+    // Speed is produced by the ADC interrupt, just pick up the latest value
+    VehicleState_Read(&vehicle);
+    currentSpeed = vehicle.speed;
+    
+    // Speed is the base layer of line 2, wake the server when the shown value changes
+    int32_t shownSpeed = SPEED_TO_TENTHS(currentSpeed);
+    if (shownSpeed != lastShownSpeed) {
+        Display_Notify();
+        lastShownSpeed = shownSpeed;
+    }
+    
+    // Check if speed has dropped below threshold after being above it
+    if (lastSpeed > SPEED_KMH(20) && currentSpeed <= SPEED_KMH(20)) {
+        DoorSystem_ResetManualOverride();  // Reset manual override when speed drops below threshold
+    }
+    
+    // Auto-lock and ignition off depend on these thresholds
+    if ((lastSpeed > SPEED_KMH(20)) != (currentSpeed > SPEED_KMH(20)) ||
+        (lastSpeed > 0) != (currentSpeed > 0)) {
+        DoorSystem_Notify();
+    }
+    
+    lastSpeed = currentSpeed;
+}
+
+// Speed Task - Runs the speed job every 100ms
 void vSpeedTask(void *pvParameters) {
-    float currentSpeed = 0.0f;
-    static float lastSpeed = 0.0f;
+    Power_RegisterTask(xTaskGetCurrentTaskHandle());
+    TickType_t release = xTaskGetTickCount();
     
     while(1) {
-        // Update speed
-        SpeedSystem_Update();
-        currentSpeed = SpeedSystem_GetCurrentSpeed();
+        Timing_Begin(TIMING_SPEED);
+        Tasks_SpeedStep();
+        Timing_End(TIMING_SPEED);
         
-        // Check if speed has dropped below threshold after being above it
-        if (lastSpeed > 20.0f && currentSpeed <= 20.0f) {
-            DoorSystem_ResetManualOverride();  // Reset manual override when speed drops below threshold
+        // Update every 100ms on an absolute grid, parked while ignition is off
+        if (Power_WaitUntil(&release, pdMS_TO_TICKS(Timing_PeriodMs(TIMING_SPEED)))) {
+            Timing_Release(TIMING_SPEED, release);
         }
-        
-        lastSpeed = currentSpeed;
-        vTaskDelay(pdMS_TO_TICKS(100)); // Update every 100ms
     }
 }
 
-// Gear Task - Monitors gear changes and updates display
+// Gear job - Monitors gear changes and updates display
+void Tasks_GearStep(void) {
+    VehicleState_t vehicle;
+    
+    // Check for gear changes
+    if(GearSystem_Update()) {  // Only update if gear changed
+        VehicleState_Read(&vehicle);
+        Trace_Record(TRACE_GEAR_CHANGE, vehicle.gear);
+        Display_Notify();
+        DoorSystem_Notify();  // Ignition on is only accepted in park
+    }
+}
+
+// Gear Task - Runs the gear job every 50ms and on switch edges
 void vGearTask(void *pvParameters) {
-    LCD_Message_t displayMsg;
-    Gear_t lastGear = GEAR_DRIVE;
+    // Switch edges wake the task at once, also while it is parked
+    InputSystem_Subscribe(INPUT_PF(0) | INPUT_PF(1), xTaskGetCurrentTaskHandle());
+    Power_RegisterTask(xTaskGetCurrentTaskHandle());
+    TickType_t release = xTaskGetTickCount();
     
     while(1) {
-        // Check for gear changes
-        if(GearSystem_Update()) {  // Only update if gear changed
-            xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-            LCD_set_cursor(0, 15);
-            const char* gearText;
-            switch(GearSystem_GetCurrentGear()) {
-                case GEAR_PARK:
-                    gearText = "P";
-                    break;
-                case GEAR_DRIVE:
-                    gearText = "D";
-                    break;
-                case GEAR_REVERSE:
-                    gearText = "R";
-                    break;
-                default:
-                    gearText = "Unknown";
-            }
-            snprintf(displayMsg.line1, sizeof(displayMsg.line1), gearText);
-            LCD_write_string(displayMsg.line1);
-            xSemaphoreGive(xLCDMutex);
-        }
+        Timing_Begin(TIMING_GEAR);
+        Tasks_GearStep();
+        Timing_End(TIMING_GEAR);
         
-        vTaskDelay(pdMS_TO_TICKS(50)); // 50ms delay
+        // Every 50ms on an absolute grid, parked while ignition is off
+        if (Power_WaitUntil(&release, pdMS_TO_TICKS(Timing_PeriodMs(TIMING_GEAR)))) {
+            Timing_Release(TIMING_GEAR, release);
+        }
     }
 }
 
-// Display Task - Updates LCD with system status
+// Initial display setup, drawn before the first update arrives
+void Tasks_InitDisplay(void) {
+    // Initial display setup, the first refresh draws lock, gear and speed
+    LCD_Clear();
+}
+
+// Display Task - Display server, the only task that touches the LCD
 void vDisplayTask(void *pvParameters) {
-    LCD_Message_t displayMsg;
+    DisplayUpdate_t update;
+    TickType_t wait;
+    TickType_t jobStart;
+    TickType_t gap;
+    TickType_t minGap = pdMS_TO_TICKS(Timing_PeriodMs(TIMING_DISPLAY));
     
-    // Initial display setup
-    xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-    LCD_Clear();
-    LCD_set_cursor(0, 0);
-    snprintf(displayMsg.line1, sizeof(displayMsg.line1), "Door: %s", 
-             (DoorSystem_GetState() == DOORS_UNLOCKED) ? "Unlocked" : "Locked  ");
-    LCD_write_string(displayMsg.line1);
+    Tasks_InitDisplay();
+    wait = Display_Refresh();
     
-    LCD_set_cursor(0, 15);
-    const char* gearText;
-    switch(GearSystem_GetCurrentGear()) {
-        case GEAR_PARK:
-            gearText = "P";
-            break;
-        case GEAR_DRIVE:
-            gearText = "D";
-            break;
-        case GEAR_REVERSE:
-            gearText = "R";
-            break;
-        default:
-            gearText = "Unknown";
+    while(1) {
+        // Sleep until the next update or the next layer expiry, whichever is first
+        BaseType_t received = xQueueReceive(xDisplayQueue, &update, wait);
+        
+        jobStart = xTaskGetTickCount();
+        Timing_Begin(TIMING_DISPLAY);
+        // One job takes everything that queued up since the last one
+        while (received == pdPASS) {
+            Display_Apply(&update);
+            received = xQueueReceive(xDisplayQueue, &update, 0);
+        }
+        wait = Display_Refresh();
+        Timing_End(TIMING_DISPLAY);
+        
+        // Lowest priority task, report WCET budget overruns from here
+        Timing_ReportOverruns();
+        
+        // Sporadic task: no new job before the minimum inter-arrival time
+        gap = xTaskGetTickCount() - jobStart;
+        if (gap < minGap) {
+            vTaskDelay(minGap - gap);
+            if (wait != portMAX_DELAY) {
+                wait = (wait > minGap - gap) ? wait - (minGap - gap) : 0;
+            }
+        }
     }
-    snprintf(displayMsg.line1, sizeof(displayMsg.line1), gearText);
-    LCD_write_string(displayMsg.line1);
+}
+
+// Ignition status job - Displays ignition status on LCD
+void Tasks_IgnitionStatusStep(void) {
+    static uint8_t lastIgnitionState = 1;  // Default high (ignition on)
+    VehicleState_t vehicle;
     
-    LCD_set_cursor(1, 0);
-    if(GearSystem_GetCurrentGear() == GEAR_REVERSE) {
-        snprintf(displayMsg.line2, sizeof(displayMsg.line2), "Dist=%.1f cm  ", 
-                 UltrasonicSystem_GetDistance());
-    } else {
-        snprintf(displayMsg.line2, sizeof(displayMsg.line2), "Speed=%.1f km/h  ", 
-                 SpeedSystem_GetCurrentSpeed());
-    }
-    LCD_write_string(displayMsg.line2);
-    xSemaphoreGive(xLCDMutex);
+    VehicleState_Read(&vehicle);
+    uint8_t currentIgnitionState = vehicle.ignitionOn;
     
-    while(1) {
-        // Only update gear display, let speed task handle speed/distance
-        xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-        LCD_set_cursor(0, 15);
-        const char* gearText;
-        switch(GearSystem_GetCurrentGear()) {
-            case GEAR_PARK:
-                gearText = "P";
-                break;
-            case GEAR_DRIVE:
-                gearText = "D";
-                break;
-            case GEAR_REVERSE:
-                gearText = "R";
-                break;
-            default:
-                gearText = "Unknown";
-        }
-        snprintf(displayMsg.line1, sizeof(displayMsg.line1), gearText);
-        LCD_write_string(displayMsg.line1);
-        xSemaphoreGive(xLCDMutex);
+    // Check if ignition state changed
+    if (currentIgnitionState != lastIgnitionState) {
+        // Transient line 1 message, the display server raises it from the
+        // vehicle state and reverts it after 1 second
+        Display_Notify();
         
-        vTaskDelay(pdMS_TO_TICKS(1000)); // Update every second
+        // Update last state
+        lastIgnitionState = currentIgnitionState;
     }
 }
 
-// Ignition Status Task - Displays ignition status on LCD
+// Ignition Status Task - Runs the ignition status job every 100ms
 void vIgnitionStatusTask(void *pvParameters) {
-    LCD_Message_t displayMsg;
-    static uint8_t lastIgnitionState = 1;  // Default high (ignition on)
-    static uint32_t statusDisplayTime = 0;
-    static uint8_t showingStatus = 0;
+    // Woken by Power_Update when the ignition comes back on
+    Power_RegisterTask(xTaskGetCurrentTaskHandle());
+    TickType_t release = xTaskGetTickCount();
     
     while(1) {
-        uint8_t currentIgnitionState = DoorSystem_IsIgnitionOn();
+        Timing_Begin(TIMING_IGNITION_STATUS);
+        Tasks_IgnitionStatusStep();
+        Timing_End(TIMING_IGNITION_STATUS);
         
-        // Check if ignition state changed
-        if (currentIgnitionState != lastIgnitionState) {
-            uint32_t currentTime = xTaskGetTickCount();
-            
-            xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-            // Only update the first line, preserve the second line
-            LCD_set_cursor(0, 0);
-            
-            if (currentIgnitionState) {
-                snprintf(displayMsg.line1, sizeof(displayMsg.line1), "Ignition: ON  ");
-            } else {
-                snprintf(displayMsg.line1, sizeof(displayMsg.line1), "Ignition: OFF ");
-            }
-            
-            LCD_write_string(displayMsg.line1);
-            xSemaphoreGive(xLCDMutex);
-            
-            showingStatus = 1;
-            statusDisplayTime = currentTime;
-            
-            // Update last state
-            lastIgnitionState = currentIgnitionState;
-        }
-        // If showing status message and 1 second has passed, return to normal display
-        else if (showingStatus && (xTaskGetTickCount() - statusDisplayTime > pdMS_TO_TICKS(1000))) {
-            xSemaphoreTake(xLCDMutex, portMAX_DELAY);
-            LCD_set_cursor(0, 0);
-            snprintf(displayMsg.line1, sizeof(displayMsg.line1), "Door: %s", 
-                    (DoorSystem_GetState() == DOORS_UNLOCKED) ? "Unlocked" : "Locked  ");
-            LCD_write_string(displayMsg.line1);
-            xSemaphoreGive(xLCDMutex);
-            
-            showingStatus = 0;
+        // Every 100ms on an absolute grid, parked while ignition is off
+        if (Power_WaitUntil(&release, pdMS_TO_TICKS(Timing_PeriodMs(TIMING_IGNITION_STATUS)))) {
+            Timing_Release(TIMING_IGNITION_STATUS, release);
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(100)); // 100ms delay
     }
 }
@@ -0,0 +1,27 @@
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Task entry points, one per periodic job
+void vDoorLockTask(void *pvParameters);
+void vDoorOpenCloseTask(void *pvParameters);
+void vSpeedTask(void *pvParameters);
+void vDisplayTask(void *pvParameters);
+void vGearTask(void *pvParameters);
+void vUltrasonicTask(void *pvParameters);
+void vIgnitionStatusTask(void *pvParameters);
+
+// One job of each task, shared by the tasks and the cyclic executive
+void Tasks_InitUltrasonic(void);
+void Tasks_InitDisplay(void);
+uint8_t Tasks_DoorLockStep(void);               // Returns 1 if the door state changed
+void Tasks_DoorOpenCloseStep(void);
+uint8_t Tasks_UltrasonicStep(uint8_t resultReady);   // Returns 1 while in reverse
+void Tasks_SpeedStep(void);
+void Tasks_GearStep(void);
+void Tasks_IgnitionStatusStep(void);
+
+#endif // TASKS_H
@@ -0,0 +1,41 @@
+#ifndef I2C_PORT_HOST_H
+#define I2C_PORT_HOST_H
+
+#include <stdint.h>
+
+// Host side of i2c_port.h: a plain struct stands in for the I2C1 register
+// block and the kernel calls are recorded for the test to check. MCS is one
+// word here, so the test plays the controller: it reads the command the
+// engine wrote, then stores the status the next interrupt should see.
+typedef struct {
+    volatile uint32_t MSA;
+    volatile uint32_t MCS;
+    volatile uint32_t MDR;
+    volatile uint32_t MTPR;
+    volatile uint32_t MIMR;
+    volatile uint32_t MRIS;
+    volatile uint32_t MMIS;
+    volatile uint32_t MICR;
+    volatile uint32_t MCR;
+} I2CHost_Regs_t;
+
+extern I2CHost_Regs_t i2cHostRegs;
+
+#define I2C_PORT_REGS        (&i2cHostRegs)
+
+typedef void *I2CPort_Task_t;
+typedef int I2CPort_Woken_t;
+
+// Function prototypes, implemented by the test
+void I2CPort_Init(void);
+void I2CPort_EnableIrq(uint8_t priority);
+void I2CPort_EnterCritical(void);
+void I2CPort_ExitCritical(void);
+uint8_t I2CPort_SchedulerRunning(void);
+I2CPort_Task_t I2CPort_CurrentTask(void);
+void I2CPort_NotifyFromIsr(I2CPort_Task_t task, uint8_t index, I2CPort_Woken_t *woken);
+void I2CPort_ClearPending(void);
+void I2CPort_YieldFromIsr(I2CPort_Woken_t woken);
+uint32_t I2CPort_WaitNotify(uint8_t index, uint32_t timeoutMs);
+
+#endif // I2C_PORT_HOST_H
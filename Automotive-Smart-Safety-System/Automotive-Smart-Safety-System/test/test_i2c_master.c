@@ -0,0 +1,407 @@
+#include <stdio.h>
+#include "i2c_master.h"
+
+// Drives the I2C1 engine on the host. The test stands in for the controller:
+// after each command it stores the status the interrupt should find in MCS
+// and calls I2C1_Handler, as the I2C1 interrupt would.
+
+// MCS write (command) and read (status) bits, as in i2c_master.c
+#define MCS_RUN              0x01
+#define MCS_BUSY             0x01
+#define MCS_START            0x02
+#define MCS_STOP             0x04
+#define MCS_ERROR            0x02
+#define MCS_ADRACK           0x04
+#define MCS_ARBLST           0x10
+
+#define CHECK(cond) Check((cond), #cond, __LINE__)
+
+I2CHost_Regs_t i2cHostRegs;
+
+// Fake kernel state
+static int criticalDepth = 0;
+static int notifications = 0;        // Given and not yet taken
+static int yields = 0;
+static int irqPending = 0;           // NVIC pending bit of I2C1
+static I2CPort_Task_t lastNotified = NULL;
+static uint32_t (*waitHook)(uint32_t timeoutMs) = NULL;
+static int task;                     // Its address is the calling task's handle
+
+static int failures = 0;
+
+static void Check(int ok, const char *what, int line) {
+    if (!ok) {
+        printf("FAIL line %d: %s\n", line, what);
+        failures++;
+    }
+}
+
+void I2CPort_Init(void) {
+}
+
+void I2CPort_EnableIrq(uint8_t priority) {
+    (void)priority;
+}
+
+void I2CPort_EnterCritical(void) {
+    criticalDepth++;
+}
+
+void I2CPort_ExitCritical(void) {
+    criticalDepth--;
+}
+
+uint8_t I2CPort_SchedulerRunning(void) {
+    return 1;
+}
+
+I2CPort_Task_t I2CPort_CurrentTask(void) {
+    return &task;
+}
+
+void I2CPort_NotifyFromIsr(I2CPort_Task_t to, uint8_t index, I2CPort_Woken_t *woken) {
+    CHECK(index == I2C1_NOTIFY_INDEX);
+    lastNotified = to;
+    notifications++;
+    *woken = 1;
+}
+
+void I2CPort_ClearPending(void) {
+    irqPending = 0;
+}
+
+void I2CPort_YieldFromIsr(I2CPort_Woken_t woken) {
+    if (woken) yields++;
+}
+
+static uint32_t TakeNotifications(void) {
+    uint32_t taken = (uint32_t)notifications;
+    notifications = 0;
+    return taken;
+}
+
+uint32_t I2CPort_WaitNotify(uint8_t index, uint32_t timeoutMs) {
+    CHECK(index == I2C1_NOTIFY_INDEX);
+    if (timeoutMs != 0 && waitHook != NULL) {
+        return waitHook(timeoutMs);
+    }
+    return TakeNotifications();
+}
+
+// One completed byte (or error) reported through the interrupt
+static void Interrupt(uint32_t status) {
+    CHECK(criticalDepth == 0);
+    i2cHostRegs.MCS = status;
+    i2cHostRegs.MMIS = 1;
+    I2C1_Handler();
+}
+
+static void Setup(void) {
+    notifications = 0;
+    yields = 0;
+    irqPending = 0;
+    lastNotified = NULL;
+    waitHook = NULL;
+    i2cHostRegs.MCS = 0;
+    i2cHostRegs.MDR = 0;
+    i2cHostRegs.MSA = 0;
+    i2cHostRegs.MMIS = 0;
+}
+
+static void Describe(I2C_Transaction_t *txn, uint8_t addr, const uint8_t *data, uint16_t len) {
+    txn->addr = addr;
+    txn->useReg = 1;
+    txn->reg = 0x00;
+    txn->data = data;
+    txn->len = len;
+    txn->notify = &task;
+    txn->status = I2C_OK;
+}
+
+// Register byte plus two data bytes: START, RUN, then RUN with STOP
+static void TestBurst(void) {
+    static const uint8_t data[2] = { 0xA1, 0xB2 };
+    I2C_Transaction_t txn;
+
+    Setup();
+    Describe(&txn, 0x27, data, 2);
+    txn.reg = 0x40;
+
+    CHECK(I2C1_Submit(&txn) == I2C_OK);
+    CHECK(txn.status == I2C_PENDING);
+    CHECK(i2cHostRegs.MSA == (0x27 << 1));
+    CHECK(i2cHostRegs.MDR == 0x40);
+    CHECK(i2cHostRegs.MCS == (MCS_START | MCS_RUN));
+
+    Interrupt(0);
+    CHECK(i2cHostRegs.MDR == 0xA1);
+    CHECK(i2cHostRegs.MCS == MCS_RUN);
+
+    Interrupt(0);
+    CHECK(i2cHostRegs.MDR == 0xB2);
+    CHECK(i2cHostRegs.MCS == (MCS_RUN | MCS_STOP));
+    CHECK(txn.status == I2C_PENDING);
+    CHECK(notifications == 0);
+
+    Interrupt(0);
+    CHECK(txn.status == I2C_OK);
+    CHECK(notifications == 1);
+    CHECK(lastNotified == &task);
+    CHECK(yields == 1);
+
+    // Nothing on the bus any more, a stray interrupt is ignored
+    Interrupt(0);
+    CHECK(notifications == 1);
+    CHECK(criticalDepth == 0);
+}
+
+// A one byte transfer carries START, RUN and STOP in one command
+static void TestSingleByte(void) {
+    I2C_Transaction_t txn;
+
+    Setup();
+    Describe(&txn, 0x27, NULL, 0);
+    txn.reg = 0x5A;
+
+    CHECK(I2C1_Submit(&txn) == I2C_OK);
+    CHECK(i2cHostRegs.MCS == (MCS_START | MCS_RUN | MCS_STOP));
+    Interrupt(0);
+    CHECK(txn.status == I2C_OK);
+}
+
+// Address NACK: the engine issues STOP itself and reports I2C_ERR_ADDR
+static void TestAddressNack(void) {
+    static const uint8_t data[1] = { 0x11 };
+    I2C_Transaction_t txn;
+
+    Setup();
+    Describe(&txn, 0x3F, data, 1);
+
+    CHECK(I2C1_Submit(&txn) == I2C_OK);
+    Interrupt(MCS_ERROR | MCS_ADRACK);
+    CHECK(i2cHostRegs.MCS == MCS_STOP);
+    CHECK(txn.status == I2C_ERR_ADDR);
+    CHECK(notifications == 1);
+}
+
+// Data NACK after the first byte, then lost arbitration where the other
+// master owns the bus and no STOP may be sent
+static void TestDataErrors(void) {
+    static const uint8_t data[2] = { 0x11, 0x22 };
+    I2C_Transaction_t txn;
+
+    Setup();
+    Describe(&txn, 0x27, data, 2);
+    CHECK(I2C1_Submit(&txn) == I2C_OK);
+    Interrupt(0);
+    Interrupt(MCS_ERROR);
+    CHECK(i2cHostRegs.MCS == MCS_STOP);
+    CHECK(txn.status == I2C_ERR_DATA);
+
+    Setup();
+    Describe(&txn, 0x27, data, 2);
+    CHECK(I2C1_Submit(&txn) == I2C_OK);
+    Interrupt(MCS_ERROR | MCS_ARBLST);
+    CHECK(i2cHostRegs.MCS == (MCS_ERROR | MCS_ARBLST));
+    CHECK(txn.status == I2C_ERR_DATA);
+}
+
+// The ISR starts the next queued transaction as soon as one finishes. One
+// transaction is on the bus and I2C1_QUEUE_LEN more may wait behind it.
+static void TestQueue(void) {
+    static const uint8_t data[1] = { 0x33 };
+    I2C_Transaction_t txn[I2C1_QUEUE_LEN + 2];
+    uint8_t accepted = I2C1_QUEUE_LEN + 1;
+
+    Setup();
+    for (uint8_t i = 0; i <= accepted; i++) {
+        Describe(&txn[i], (uint8_t)(0x20 + i), data, 1);
+    }
+    for (uint8_t i = 0; i < accepted; i++) {
+        CHECK(I2C1_Submit(&txn[i]) == I2C_OK);
+    }
+    CHECK(I2C1_Submit(&txn[accepted]) == I2C_ERR_QUEUE);
+    CHECK(i2cHostRegs.MSA == (0x20 << 1));
+
+    for (uint8_t i = 0; i < accepted; i++) {
+        CHECK(i2cHostRegs.MSA == (uint32_t)((0x20 + i) << 1));
+        CHECK(i2cHostRegs.MCS == (MCS_START | MCS_RUN));
+        Interrupt(0);
+        Interrupt(0);
+        CHECK(txn[i].status == I2C_OK);
+    }
+    CHECK(notifications == accepted);
+}
+
+// Controller that answers every command at once, run while the caller sleeps
+static uint32_t BusCompletes(uint32_t timeoutMs) {
+    (void)timeoutMs;
+    for (int i = 0; i < 16 && notifications == 0; i++) {
+        Interrupt(0);
+    }
+    return TakeNotifications();
+}
+
+// Controller that never answers
+static uint32_t BusHangs(uint32_t timeoutMs) {
+    (void)timeoutMs;
+    return 0;
+}
+
+// Another task queues 'follower', the first byte completes, and the second
+// one finishes while the caller is already timing out: its interrupt is
+// raised but held off by the abort's critical section
+static I2C_Transaction_t *follower = NULL;
+
+static uint32_t BusStallsWithFollower(uint32_t timeoutMs) {
+    (void)timeoutMs;
+    CHECK(I2C1_Submit(follower) == I2C_OK);
+    Interrupt(0);
+    i2cHostRegs.MCS = 0;
+    i2cHostRegs.MMIS = 1;
+    irqPending = 1;
+    return 0;
+}
+
+// Completion lands after the timeout, before the abort
+static uint32_t BusCompletesLate(uint32_t timeoutMs) {
+    (void)BusCompletes(timeoutMs);
+    notifications = 1;
+    return 0;
+}
+
+// Blocking transfer: the caller sleeps until the ISR notifies it
+static void TestTransfer(void) {
+    static const uint8_t data[3] = { 1, 2, 3 };
+    I2C_Transaction_t txn;
+
+    Setup();
+    Describe(&txn, 0x27, data, 3);
+    txn.notify = NULL;
+    waitHook = BusCompletes;
+    CHECK(I2C1_Transfer(&txn) == I2C_OK);
+    CHECK(txn.notify == &task);
+    CHECK(i2cHostRegs.MDR == 3);
+}
+
+// Timeout while still queued behind another transaction: it is withdrawn
+// from the queue and never reaches the bus
+static void TestAbortQueued(void) {
+    static const uint8_t data[1] = { 0x44 };
+    I2C_Transaction_t first;
+    I2C_Transaction_t waiter;
+
+    Setup();
+    Describe(&first, 0x27, data, 1);
+    Describe(&waiter, 0x28, data, 1);
+    first.notify = NULL;
+    waitHook = BusHangs;
+
+    CHECK(I2C1_Submit(&first) == I2C_OK);
+    CHECK(I2C1_Transfer(&waiter) == I2C_ERR_TIMEOUT);
+    CHECK(i2cHostRegs.MSA == (0x27 << 1));
+
+    Interrupt(0);
+    Interrupt(0);
+    CHECK(first.status == I2C_OK);
+    CHECK(i2cHostRegs.MSA == (0x27 << 1));
+    CHECK(waiter.status == I2C_ERR_TIMEOUT);
+    CHECK(criticalDepth == 0);
+}
+
+// Timeout while the transaction is the one on the bus
+static void TestAbortOnBus(void) {
+    static const uint8_t data[2] = { 0x55, 0x66 };
+    I2C_Transaction_t txn;
+
+    Setup();
+    Describe(&txn, 0x27, data, 2);
+    waitHook = BusHangs;
+
+    CHECK(I2C1_Transfer(&txn) == I2C_ERR_TIMEOUT);
+    CHECK(i2cHostRegs.MCS == MCS_STOP);
+
+    // The interrupt of the aborted byte finds the engine idle
+    Interrupt(0);
+    CHECK(notifications == 0);
+    CHECK(txn.status == I2C_ERR_TIMEOUT);
+}
+
+// Timeout on the bus with another transaction queued: the follower takes the
+// bus, and the interrupt of the aborted byte must not advance it
+static void TestAbortOnBusWithFollower(void) {
+    static const uint8_t data[2] = { 0x55, 0x66 };
+    static const uint8_t nextData[2] = { 0x88, 0x99 };
+    I2C_Transaction_t hung;
+    I2C_Transaction_t next;
+
+    Setup();
+    Describe(&hung, 0x27, data, 2);
+    Describe(&next, 0x28, nextData, 2);
+    next.reg = 0x10;
+    next.notify = NULL;
+    follower = &next;
+    waitHook = BusStallsWithFollower;
+
+    CHECK(I2C1_Transfer(&hung) == I2C_ERR_TIMEOUT);
+    CHECK(irqPending == 0);
+    CHECK(next.status == I2C_PENDING);
+    CHECK(i2cHostRegs.MSA == (0x28 << 1));
+    CHECK(i2cHostRegs.MDR == 0x10);
+    CHECK(i2cHostRegs.MCS == (MCS_START | MCS_RUN));
+
+    // Stale interrupt after its status was cleared, and one that arrives
+    // while the follower's first byte is still on the bus
+    i2cHostRegs.MMIS = 0;
+    I2C1_Handler();
+    CHECK(i2cHostRegs.MDR == 0x10);
+    i2cHostRegs.MMIS = 1;
+    i2cHostRegs.MCS = MCS_BUSY;
+    I2C1_Handler();
+    CHECK(i2cHostRegs.MDR == 0x10);
+
+    // Every byte of the follower goes out, in order
+    Interrupt(0);
+    CHECK(i2cHostRegs.MDR == 0x88);
+    CHECK(i2cHostRegs.MCS == MCS_RUN);
+    Interrupt(0);
+    CHECK(i2cHostRegs.MDR == 0x99);
+    CHECK(i2cHostRegs.MCS == (MCS_RUN | MCS_STOP));
+    Interrupt(0);
+    CHECK(next.status == I2C_OK);
+    CHECK(hung.status == I2C_ERR_TIMEOUT);
+    CHECK(criticalDepth == 0);
+}
+
+// Completion racing the timeout keeps its result and the late give is taken
+static void TestLateCompletion(void) {
+    static const uint8_t data[1] = { 0x77 };
+    I2C_Transaction_t txn;
+
+    Setup();
+    Describe(&txn, 0x27, data, 1);
+    waitHook = BusCompletesLate;
+
+    CHECK(I2C1_Transfer(&txn) == I2C_OK);
+    CHECK(notifications == 0);
+}
+
+int main(void) {
+    TestBurst();
+    TestSingleByte();
+    TestAddressNack();
+    TestDataErrors();
+    TestQueue();
+    TestTransfer();
+    TestAbortQueued();
+    TestAbortOnBus();
+    TestAbortOnBusWithFollower();
+    TestLateCompletion();
+
+    if (failures != 0) {
+        printf("test_i2c_master: %d failed\n", failures);
+        return 1;
+    }
+    printf("test_i2c_master: all passed\n");
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "text_format.h"
+
+// Digits are produced least significant first, backwards from 'first' in a
+// scratch buffer, and the finished number is copied out in one piece; a
+// divide by a constant 10 compiles to a multiply.
+static char *PrependUnsigned(char *first, uint32_t value) {
+    do {
+        *--first = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    return first;
+}
+
+// A number goes out whole or not at all, never as a misleading prefix
+static char *AppendNumber(char *p, char *end, const char *first, const char *last) {
+    if (last - first > end - p) {
+        while (p < end) {
+            *p++ = '*';
+        }
+        return p;
+    }
+
+    while (first < last) {
+        *p++ = *first++;
+    }
+    return p;
+}
+
+static uint32_t Magnitude(int32_t value) {
+    return (value < 0) ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+}
+
+char *Format_Text(char *p, char *end, const char *text) {
+    while (*text && p < end) {
+        *p++ = *text++;
+    }
+    return p;
+}
+
+char *Format_Int(char *p, char *end, int32_t value) {
+    char scratch[FORMAT_INT_MAX_CHARS];
+    char *last = scratch + sizeof(scratch);
+    char *first = PrependUnsigned(last, Magnitude(value));
+
+    if (value < 0) *--first = '-';
+    return AppendNumber(p, end, first, last);
+}
+
+char *Format_Tenths(char *p, char *end, int32_t tenths) {
+    char scratch[FORMAT_INT_MAX_CHARS + 1];     // Sign, nine digits, point, tenth
+    char *last = scratch + sizeof(scratch);
+    char *first = last;
+    uint32_t magnitude = Magnitude(tenths);
+
+    *--first = (char)('0' + magnitude % 10);
+    *--first = '.';
+    first = PrependUnsigned(first, magnitude / 10);
+    if (tenths < 0) *--first = '-';
+    return AppendNumber(p, end, first, last);
+}
+
+// Spaces overwrite whatever a longer previous text left in the field
+void Format_Pad(char *p, char *end) {
+    while (p < end) {
+        *p++ = ' ';
+    }
+    *p = '\0';
+}
+
+#ifdef FORMAT_BENCHMARK
+#include "TM4C123GH6PM.h"
+#include <stdio.h>
+
+#define BENCH_VALUES        1001      // 0.0 to 100.0 in tenths
+#define BENCH_STACK_WORDS   256       // Painted below the caller's frame
+#define BENCH_STACK_PAINT   0xA5A5A5A5UL
+
+static char benchLine[17];
+
+static void FormatSnprintf(void) {
+    for (int32_t v = 0; v < BENCH_VALUES; v++) {
+        snprintf(benchLine, sizeof(benchLine), "Speed=%.1f km/h  ", v / 10.0f);
+    }
+}
+
+static void FormatFixed(void) {
+    char *end = benchLine + sizeof(benchLine) - 1;
+
+    for (int32_t v = 0; v < BENCH_VALUES; v++) {
+        char *p = Format_Text(benchLine, end, "Speed=");
+        p = Format_Tenths(p, end, v);
+        p = Format_Text(p, end, " km/h");
+        Format_Pad(p, end);
+    }
+}
+
+// Bytes of main stack a call uses: paint the free stack below SP, run the
+// call and find the deepest word it overwrote
+static uint32_t StackBytes(void (*fn)(void)) {
+    volatile uint32_t *sp = (volatile uint32_t *)__get_MSP();
+    uint32_t used = 0;
+
+    for (uint32_t i = 1; i <= BENCH_STACK_WORDS; i++) {
+        sp[-(int32_t)i] = BENCH_STACK_PAINT;
+    }
+    fn();
+    for (uint32_t i = BENCH_STACK_WORDS; i > 0; i--) {
+        if (sp[-(int32_t)i] != BENCH_STACK_PAINT) {
+            used = i * 4;
+            break;
+        }
+    }
+    return used;
+}
+
+static uint32_t Cycles(void (*fn)(void)) {
+    uint32_t start = DWT->CYCCNT;
+    fn();
+    return DWT->CYCCNT - start;
+}
+
+// Cycles per speed line and stack use of snprintf %.1f against the integer
+// formatter. Run before the scheduler starts, on the main stack. This build
+// links the float printf support only for the reference path.
+void Format_Benchmark(void) {
+    uint32_t snprintfCycles;
+    uint32_t fixedCycles;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    snprintfCycles = Cycles(FormatSnprintf) / BENCH_VALUES;
+    fixedCycles = Cycles(FormatFixed) / BENCH_VALUES;
+
+    printf("Format benchmark (cycles/line): snprintf=%lu fixed=%lu\n",
+           (unsigned long)snprintfCycles, (unsigned long)fixedCycles);
+    printf("Format benchmark (stack bytes): snprintf=%lu fixed=%lu\n",
+           (unsigned long)StackBytes(FormatSnprintf), (unsigned long)StackBytes(FormatFixed));
+}
+#endif
@@ -0,0 +1,22 @@
+#ifndef TEXT_FORMAT_H
+#define TEXT_FORMAT_H
+
+#include <stdint.h>
+
+// Integer text formatting for the LCD. Each call appends at p, never past
+// end, and returns the new position; Format_Pad closes a field. end is one
+// past the last character of the field and the terminator goes at end, so
+// the buffer holds one byte more. Text is cut at end, a number that does not
+// fit is shown as '*' in the space left. No floating point and no printf.
+#define FORMAT_INT_MAX_CHARS   11      // "-2147483648"
+
+// Function prototypes
+char *Format_Text(char *p, char *end, const char *text);
+char *Format_Int(char *p, char *end, int32_t value);
+char *Format_Tenths(char *p, char *end, int32_t tenths);   // 123 -> "12.3"
+void Format_Pad(char *p, char *end);                       // Space fill to end, then terminate
+#ifdef FORMAT_BENCHMARK
+void Format_Benchmark(void);
+#endif
+
+#endif // TEXT_FORMAT_H
@@ -0,0 +1,377 @@
+#include "timing_analysis.h"
+#include "TM4C123GH6PM.h"
+#include "timers.h"
+#include "power_system.h"
+#include "ultrasonic_system.h"
+#include "input_system.h"
+#include <stdio.h>
+
+// Rate-monotonic timing model. Shorter period means higher priority, and equal
+// periods are ordered by table position so no two tasks share a priority and
+// time slicing never interleaves them. Measured execution time is wall clock
+// from Timing_Begin to Timing_End, so it includes preemption and interrupts
+// and is a safe upper bound on the real WCET.
+//
+// The display server is event driven, not periodic. It is modelled as a
+// sporadic task whose period is the minimum inter-arrival time of its jobs,
+// which vDisplayTask enforces by holding off the next job until that much
+// time has passed since the last one began. Updates arriving in between wait
+// in the queue and are applied together by the next job.
+//
+// The ultrasonic task is sporadic too: in reverse it runs once per
+// measurement, so its jobs arrive at the ranging rate, at most
+// ULTRASONIC_MAX_RATE_HZ whatever rate is configured at run time.
+//
+// The input sampler runs only while an input is moving, at most once every
+// INPUT_SAMPLE_MS. The timer task sits below every analysed priority, so the
+// report callbacks it runs, printf included, never delay an analysed job.
+
+typedef struct {
+    const char *name;
+    uint32_t periodMs;           // Period or minimum inter-arrival time, also the deadline
+    uint32_t budgetUs;           // WCET assumed by the boot-time check
+    uint32_t startCycles;        // DWT stamp of the current job
+    uint32_t wcetCycles;         // Longest job measured so far
+    uint8_t overrun;             // Budget exceeded, not yet reported
+    uint8_t reported;            // Overrun reported once already
+    UBaseType_t priority;
+} TaskTiming_t;
+
+static TaskTiming_t timing[TIMING_TASK_COUNT] = {
+    { "Inputs",         INPUT_SAMPLE_MS, INPUT_SAMPLE_BUDGET_US, 0, 0, 0, 0, 0 },   // Sporadic, while an input moves
+    { "Gear",           50,   100,   0, 0, 0, 0, 0 },
+    { "DoorOpenClose",  100,  150,   0, 0, 0, 0, 0 },
+    { "DoorLock",       100,  150,   0, 0, 0, 0, 0 },
+    { "Speed",          100,  100,   0, 0, 0, 0, 0 },
+    { "Ultrasonic",     1000 / ULTRASONIC_MAX_RATE_HZ, 300, 0, 0, 0, 0, 0 },   // Sporadic, one job per measurement
+    { "IgnitionStatus", 100,  50,    0, 0, 0, 0, 0 },
+    { "Display",        100,  15000, 0, 0, 0, 0, 0 }   // Sporadic, two full LCD lines over I2C
+};
+
+// CYCCNT stops while the core waits in WFI, the tickless sleep adds back the
+// cycles it measured on the wake timer
+static volatile uint32_t sleepCycles = 0;
+
+// Run time stats: cycle counter value at the last report, overall and per task
+// (indexed by the kernel task number)
+static TaskStatus_t taskStatus[TIMING_MAX_TASKS];
+static uint32_t lastTotalCycles = 0;
+static uint32_t lastTaskCycles[TIMING_MAX_TASKS];
+
+// Switches to a different task, counted by the kernel's switch hook
+static volatile uint32_t contextSwitches = 0;
+static uint32_t lastContextSwitches = 0;
+static void *lastTcb = NULL;
+static StaticTimer_t cpuReportTimerBuffer;
+
+// Release grid of each periodic task in cycles, anchored on its best release
+typedef struct {
+    uint8_t anchored;
+    TickType_t lastTick;         // Tick of the previous release
+    uint32_t lastStart;          // Cycle counter when the previous release ran
+    uint32_t gridCycles;         // Grid point of the previous release
+} ReleaseGrid_t;
+
+static ReleaseGrid_t grids[TIMING_TASK_COUNT];
+static TimingHistogram_t histograms[TIMING_TASK_COUNT];
+
+static void Timing_CpuReportTick(TimerHandle_t timer);
+
+static uint32_t CyclesToUs(uint32_t cycles) {
+    return cycles / (SystemCoreClock / 1000000);
+}
+
+// Also the kernel's portCONFIGURE_TIMER_FOR_RUN_TIME_STATS, so it leaves a
+// running counter alone
+void Timing_StartCycleCounter(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t Timing_RunTimeCounter(void) {
+    return DWT->CYCCNT + sleepCycles;
+}
+
+// Called with interrupts disabled
+void Timing_AddSleepCycles(uint32_t cycles) {
+    sleepCycles += cycles;
+}
+
+// traceTASK_SWITCHED_IN, inside the kernel's context switch with interrupts
+// masked. The scheduler also runs when it keeps the current task, which is
+// not a switch.
+void Timing_TaskSwitchedIn(void *tcb) {
+    if (tcb != lastTcb) {
+        lastTcb = tcb;
+        contextSwitches++;
+    }
+}
+
+void Timing_Init(void) {
+    TimerHandle_t report;
+
+    DWT->CYCCNT = 0;
+    Timing_StartCycleCounter();
+
+    // Rate-monotonic order: a task sits above every task with a longer
+    // period and above equal-period tasks listed after it
+    for (uint8_t i = 0; i < TIMING_TASK_COUNT; i++) {
+        UBaseType_t below = 0;
+        for (uint8_t j = 0; j < TIMING_TASK_COUNT; j++) {
+            if (timing[j].periodMs > timing[i].periodMs ||
+                (timing[j].periodMs == timing[i].periodMs && j > i)) {
+                below++;
+            }
+        }
+        timing[i].priority = TIMING_BASE_PRIORITY + below;
+    }
+
+    Timing_CheckSchedulability(0);
+
+    report = xTimerCreateStatic("CpuLoad", pdMS_TO_TICKS(TIMING_CPU_REPORT_MS), pdTRUE,
+                                NULL, Timing_CpuReportTick, &cpuReportTimerBuffer);
+    xTimerStart(report, 0);
+    Power_RegisterTimer(report);       // Paused while the ignition is off
+}
+
+UBaseType_t Timing_Priority(TimingTask_t task) {
+    return timing[task].priority;
+}
+
+uint32_t Timing_PeriodMs(TimingTask_t task) {
+    return timing[task].periodMs;
+}
+
+void Timing_Begin(TimingTask_t task) {
+    timing[task].startCycles = Timing_RunTimeCounter();
+}
+
+// Each task only touches its own entry, no locking needed
+void Timing_End(TimingTask_t task) {
+    TaskTiming_t *t = &timing[task];
+    uint32_t elapsed = Timing_RunTimeCounter() - t->startCycles;
+
+    if (elapsed > t->wcetCycles) {
+        t->wcetCycles = elapsed;
+        if (!t->reported && CyclesToUs(elapsed) > t->budgetUs) {
+            t->overrun = 1;
+        }
+    }
+}
+
+uint32_t Timing_GetWcetUs(TimingTask_t task) {
+    return CyclesToUs(timing[task].wcetCycles);
+}
+
+// Execution time used by the analysis, in us
+static uint32_t AnalysisWcetUs(uint8_t i, uint8_t useMeasured) {
+    uint32_t wcet = timing[i].budgetUs;
+    if (useMeasured && CyclesToUs(timing[i].wcetCycles) > wcet) {
+        wcet = CyclesToUs(timing[i].wcetCycles);
+    }
+    return wcet;
+}
+
+// Response-time analysis: R = C + sum over higher priority tasks of
+// ceil(R / Tj) * Cj, iterated to a fixed point or past the deadline
+uint8_t Timing_CheckSchedulability(uint8_t useMeasured) {
+    uint8_t schedulable = 1;
+    uint64_t utilisation = 0;    // Parts per million, each term rounded up
+
+    for (uint8_t i = 0; i < TIMING_TASK_COUNT; i++) {
+        uint32_t deadline = timing[i].periodMs * 1000;
+        uint32_t wcet = AnalysisWcetUs(i, useMeasured);
+        uint32_t response = wcet;
+        uint32_t previous = 0;
+
+        utilisation += ((uint64_t)wcet * 1000 + timing[i].periodMs - 1) / timing[i].periodMs;
+
+        while (response != previous && response <= deadline) {
+            previous = response;
+            response = wcet;
+            for (uint8_t j = 0; j < TIMING_TASK_COUNT; j++) {
+                if (timing[j].priority > timing[i].priority) {
+                    uint32_t period = timing[j].periodMs * 1000;
+                    response += ((previous + period - 1) / period) * AnalysisWcetUs(j, useMeasured);
+                }
+            }
+        }
+
+        if (response > deadline) {
+            printf("RTA: %s misses its deadline (R > %lu us, prio %lu)\n", timing[i].name,
+                   (unsigned long)deadline, (unsigned long)timing[i].priority);
+            schedulable = 0;
+        }
+    }
+
+    // Round up once more to per mille, the report never understates the load
+    utilisation = (utilisation + 999) / 1000;
+    printf("RTA (%s): U = %lu.%lu%%, %s\n", useMeasured ? "measured" : "budget",
+           (unsigned long)(utilisation / 10), (unsigned long)(utilisation % 10),
+           schedulable ? "schedulable" : "NOT schedulable");
+    return schedulable;
+}
+
+// Report each task whose measured WCET went past its budget, then re-run the
+// analysis with the measured values. Call from a low priority task.
+void Timing_ReportOverruns(void) {
+    uint8_t any = 0;
+
+    for (uint8_t i = 0; i < TIMING_TASK_COUNT; i++) {
+        if (timing[i].overrun) {
+            timing[i].overrun = 0;
+            timing[i].reported = 1;
+            printf("WCET: %s took %lu us, budget %lu us\n", timing[i].name,
+                   (unsigned long)CyclesToUs(timing[i].wcetCycles),
+                   (unsigned long)timing[i].budgetUs);
+            any = 1;
+        }
+    }
+
+    if (any) {
+        Timing_CheckSchedulability(1);
+    }
+}
+
+// Share of each task in the cycles since the last report. Interrupt time is
+// charged to the task it interrupted. The 32-bit counters wrap after about
+// 268 s at 16 MHz, far longer than the report period, so differences hold.
+void Timing_ReportCpuLoad(void) {
+    uint32_t total;
+    uint32_t elapsed;
+    uint32_t switches = contextSwitches - lastContextSwitches;
+    uint32_t idle = 0;           // Per mille
+    UBaseType_t count = uxTaskGetSystemState(taskStatus, TIMING_MAX_TASKS, &total);
+
+    lastContextSwitches += switches;
+
+    elapsed = total - lastTotalCycles;
+    lastTotalCycles = total;
+    if (elapsed == 0) return;
+
+    for (UBaseType_t i = 0; i < count; i++) {
+        TaskStatus_t *s = &taskStatus[i];
+        uint32_t used;
+        uint32_t share;
+
+        if (s->xTaskNumber >= TIMING_MAX_TASKS) continue;
+        used = s->ulRunTimeCounter - lastTaskCycles[s->xTaskNumber];
+        lastTaskCycles[s->xTaskNumber] = s->ulRunTimeCounter;
+        share = (uint32_t)(((uint64_t)used * 1000) / elapsed);
+
+        // Only the idle task runs at the idle priority
+        if (s->uxBasePriority == tskIDLE_PRIORITY) {
+            idle = share;
+        }
+        printf("CPU %-15s %3lu.%lu%%\n", s->pcTaskName,
+               (unsigned long)(share / 10), (unsigned long)(share % 10));
+    }
+
+    if (idle > 1000) idle = 1000;
+    // Same report in the multitask and the CYCLIC_EXECUTIVE build, so the
+    // switch rates of the two can be compared directly
+    printf("CPU load %lu.%lu%%, idle %lu.%lu%%, %lu context switches/s\n",
+           (unsigned long)((1000 - idle) / 10), (unsigned long)((1000 - idle) % 10),
+           (unsigned long)(idle / 10), (unsigned long)(idle % 10),
+           (unsigned long)(((uint64_t)switches * SystemCoreClock) / elapsed));
+}
+
+static uint8_t HistogramBin(uint32_t us) {
+    uint32_t bin = us / TIMING_HIST_BIN_US;
+    return (bin < TIMING_HIST_BINS) ? (uint8_t)bin : TIMING_HIST_BINS - 1;
+}
+
+// Record one periodic release of a task. The ideal release is not visible in
+// cycles, so the grid is anchored on the first release and moved down to any
+// release that starts earlier than it predicts; jitter is then the delay over
+// the best observed release. Arithmetic is modulo 2^32 like the counter, so
+// long parked gaps stay consistent.
+void Timing_Release(TimingTask_t task, TickType_t releaseTick) {
+    ReleaseGrid_t *g = &grids[task];
+    TimingHistogram_t *h = &histograms[task];
+    uint32_t now = Timing_RunTimeCounter();
+    uint32_t cyclesPerTick = SystemCoreClock / configTICK_RATE_HZ;
+    uint32_t grid;
+    int32_t late;
+
+    if (!g->anchored) {
+        g->anchored = 1;
+        g->lastTick = releaseTick;
+        g->lastStart = now;
+        g->gridCycles = now;
+        h->minPeriodUs = 0xFFFFFFFFUL;
+        return;
+    }
+
+    grid = g->gridCycles + (uint32_t)(releaseTick - g->lastTick) * cyclesPerTick;
+    late = (int32_t)(now - grid);
+    if (late < 0) {
+        grid = now;
+        late = 0;
+    }
+
+    taskENTER_CRITICAL();
+    h->releases++;
+    h->jitter[HistogramBin(CyclesToUs((uint32_t)late))]++;
+    if (CyclesToUs((uint32_t)late) > h->maxJitterUs) {
+        h->maxJitterUs = CyclesToUs((uint32_t)late);
+    }
+
+    // Period only between back to back releases
+    if (releaseTick - g->lastTick == pdMS_TO_TICKS(timing[task].periodMs)) {
+        uint32_t periodUs = CyclesToUs(now - g->lastStart);
+        uint32_t nominalUs = timing[task].periodMs * 1000;
+        uint32_t deviation = (periodUs > nominalUs) ? periodUs - nominalUs : nominalUs - periodUs;
+
+        h->periodDeviation[HistogramBin(deviation)]++;
+        if (periodUs < h->minPeriodUs) h->minPeriodUs = periodUs;
+        if (periodUs > h->maxPeriodUs) h->maxPeriodUs = periodUs;
+    }
+    taskEXIT_CRITICAL();
+
+    g->lastTick = releaseTick;
+    g->lastStart = now;
+    g->gridCycles = grid;
+}
+
+void Timing_GetHistogram(TimingTask_t task, TimingHistogram_t *out) {
+    taskENTER_CRITICAL();
+    *out = histograms[task];
+    taskEXIT_CRITICAL();
+}
+
+// One line per task that has periodic releases: jitter bins, then period
+// deviation bins, each TIMING_HIST_BIN_US wide
+void Timing_ReportHistograms(void) {
+    TimingHistogram_t h;
+
+    for (uint8_t i = 0; i < TIMING_TASK_COUNT; i++) {
+        Timing_GetHistogram((TimingTask_t)i, &h);
+        if (h.releases == 0) continue;
+
+        printf("Release %-15s n=%lu jitter max %lu us, period %lu..%lu us\n  jitter:",
+               timing[i].name, (unsigned long)h.releases, (unsigned long)h.maxJitterUs,
+               (unsigned long)h.minPeriodUs, (unsigned long)h.maxPeriodUs);
+        for (uint8_t b = 0; b < TIMING_HIST_BINS; b++) {
+            printf(" %lu", (unsigned long)h.jitter[b]);
+        }
+        printf("\n  period:");
+        for (uint8_t b = 0; b < TIMING_HIST_BINS; b++) {
+            printf(" %lu", (unsigned long)h.periodDeviation[b]);
+        }
+        printf("\n");
+    }
+}
+
+static void Timing_CpuReportTick(TimerHandle_t timer) {
+    static uint32_t elapsedMs = 0;
+
+    (void)timer;
+    Timing_ReportCpuLoad();
+
+    elapsedMs += TIMING_CPU_REPORT_MS;
+    if (elapsedMs >= TIMING_HIST_REPORT_MS) {
+        elapsedMs = 0;
+        Timing_ReportHistograms();
+    }
+}
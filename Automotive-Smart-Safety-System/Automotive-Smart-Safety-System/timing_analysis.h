@@ -0,0 +1,65 @@
+#ifndef TIMING_ANALYSIS_H
+#define TIMING_ANALYSIS_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Lowest priority handed out; the rest count up from here
+#define TIMING_BASE_PRIORITY  2
+
+// CPU load report
+#define TIMING_CPU_REPORT_MS  5000    // Period of the per task CPU report
+#define TIMING_MAX_TASKS      12      // Application tasks and input sampler plus idle and timer tasks
+
+// Release histograms
+#define TIMING_HIST_BINS      8       // Last bin collects everything above
+#define TIMING_HIST_BIN_US    250     // Bin width
+#define TIMING_HIST_REPORT_MS 30000   // Period of the histogram report
+
+// Tasks under analysis (inputs, display and ultrasonic are sporadic), in tie-break order for
+// equal periods (listed first = more critical = higher priority). The timer task runs below
+// all of them and is left out.
+typedef enum {
+    TIMING_INPUTS,
+    TIMING_GEAR,
+    TIMING_DOOR_OPEN_CLOSE,
+    TIMING_DOOR_LOCK,
+    TIMING_SPEED,
+    TIMING_ULTRASONIC,
+    TIMING_IGNITION_STATUS,
+    TIMING_DISPLAY,
+    TIMING_TASK_COUNT
+} TimingTask_t;
+
+// Release timing of one periodic task. Jitter is how late a job started
+// against its release grid, period deviation is how far the time between two
+// consecutive releases was from the nominal period.
+typedef struct {
+    uint32_t releases;
+    uint32_t jitter[TIMING_HIST_BINS];           // Bins of TIMING_HIST_BIN_US
+    uint32_t periodDeviation[TIMING_HIST_BINS];  // Bins of TIMING_HIST_BIN_US
+    uint32_t maxJitterUs;
+    uint32_t minPeriodUs;
+    uint32_t maxPeriodUs;
+} TimingHistogram_t;
+
+// Function prototypes
+void Timing_Init(void);                       // Before any task is created
+UBaseType_t Timing_Priority(TimingTask_t task);
+uint32_t Timing_PeriodMs(TimingTask_t task);
+void Timing_Begin(TimingTask_t task);         // Start of one job
+void Timing_End(TimingTask_t task);           // End of the job, before blocking
+uint32_t Timing_GetWcetUs(TimingTask_t task);
+uint8_t Timing_CheckSchedulability(uint8_t useMeasured);   // Returns 1 if every deadline holds
+void Timing_ReportOverruns(void);             // Reports tasks that exceeded their WCET budget
+void Timing_StartCycleCounter(void);
+uint32_t Timing_RunTimeCounter(void);         // Cycles, including time asleep, also the kernel's run time counter
+void Timing_AddSleepCycles(uint32_t cycles);  // From the tickless sleep only
+void Timing_TaskSwitchedIn(void *tcb);        // Kernel switch hook, counts context switches
+void Timing_ReportCpuLoad(void);              // CPU share per task since the last report
+void Timing_Release(TimingTask_t task, TickType_t releaseTick);   // Periodic wakeup, before the job
+void Timing_GetHistogram(TimingTask_t task, TimingHistogram_t *histogram);
+void Timing_ReportHistograms(void);
+
+#endif // TIMING_ANALYSIS_H
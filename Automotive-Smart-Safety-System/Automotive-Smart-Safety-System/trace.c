@@ -0,0 +1,79 @@
+#include "trace.h"
+#include "timing_analysis.h"
+#include "TM4C123GH6PM.h"
+
+// Lock-free trace recorder. Producers in any task or ISR claim a slot by
+// bumping the head with LDREX/STREX, fill it and commit it by writing the
+// event byte last. The idle hook is the only consumer: it sends committed
+// records to ITM and frees them. A producer preempted between claim and
+// commit only holds up the drain, never another producer.
+
+static TraceRecord_t traceBuffer[TRACE_BUFFER_SIZE];
+static volatile uint32_t traceHead = 0;        // Next slot to claim
+static volatile uint32_t traceTail = 0;        // Next slot to drain
+static volatile uint32_t traceDropped = 0;
+
+void Trace_Record(TraceEvent_t event, uint16_t data) {
+    uint32_t timestamp = Timing_RunTimeCounter();
+    uint32_t index;
+    TraceRecord_t *record;
+
+    do {
+        index = __LDREXW(&traceHead);
+        if (index - traceTail >= TRACE_BUFFER_SIZE) {
+            // Full, keep the older records and count the loss
+            __CLREX();
+            do {
+                index = __LDREXW(&traceDropped);
+            } while (__STREXW(index + 1, &traceDropped));
+            return;
+        }
+    } while (__STREXW(index + 1, &traceHead));
+
+    record = &traceBuffer[index & (TRACE_BUFFER_SIZE - 1)];
+    record->timestamp = timestamp;
+    record->sequence = (uint8_t)index;
+    record->data = data;
+    __DMB();
+    record->event = (uint8_t)event;
+}
+
+static void SendWord(uint32_t word) {
+    while (ITM->PORT[TRACE_ITM_PORT].u32 == 0);
+    ITM->PORT[TRACE_ITM_PORT].u32 = word;
+}
+
+// Without a host listening on the port the records are discarded so the
+// buffer keeps holding the latest events
+void Trace_Drain(void) {
+    uint8_t listening = (ITM->TCR & ITM_TCR_ITMENA_Msk) &&
+                        (ITM->TER & (1UL << TRACE_ITM_PORT));
+
+    while (traceTail != traceHead) {
+        TraceRecord_t *record = &traceBuffer[traceTail & (TRACE_BUFFER_SIZE - 1)];
+        uint8_t event = record->event;
+
+        // Claimed but not committed yet, pick it up on the next pass
+        if (event == 0) break;
+        __DMB();
+
+        if (listening) {
+            SendWord(record->timestamp);
+            SendWord(event | ((uint32_t)record->sequence << 8) | ((uint32_t)record->data << 16));
+        }
+
+        record->event = 0;
+        __DMB();
+        traceTail++;
+    }
+}
+
+uint32_t Trace_GetDropped(void) {
+    return traceDropped;
+}
+
+// Runs on every idle loop before the tickless sleep, so the drain never
+// costs an extra wakeup
+void vApplicationIdleHook(void) {
+    Trace_Drain();
+}
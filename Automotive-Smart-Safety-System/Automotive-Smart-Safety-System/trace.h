@@ -0,0 +1,35 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// Trace recorder configuration
+#define TRACE_BUFFER_SIZE   256     // Records, power of two
+#define TRACE_ITM_PORT      1       // Stimulus port of the binary stream, printf uses 0
+
+// Recorded events. 0 marks a slot that is reserved but not yet written.
+typedef enum {
+    TRACE_INPUT_EDGE = 1,        // data: debounced inputs that toggled (door inputs and switches)
+    TRACE_GEAR_CHANGE,           // data: new Gear_t
+    TRACE_ADC_SAMPLE,            // data: filtered ADC value
+    TRACE_ECHO_CAPTURE,          // data: distance in mm
+    TRACE_LCD_FLUSH_START,       // data: LCD row
+    TRACE_LCD_FLUSH_END,         // data: LCD row
+    TRACE_OUTPUT_CHANGE          // data: OutputArbiter_GetOutputs after the change
+} TraceEvent_t;
+
+// One record, sent over ITM as two words: timestamp, then
+// event | sequence << 8 | data << 16
+typedef struct {
+    uint32_t timestamp;          // Timing_RunTimeCounter cycles
+    volatile uint8_t event;      // Written last, commits the record
+    uint8_t sequence;            // Low byte of the record index, gaps show drops
+    uint16_t data;
+} TraceRecord_t;
+
+// Function prototypes
+void Trace_Record(TraceEvent_t event, uint16_t data);   // Any task or ISR
+void Trace_Drain(void);                                 // Idle hook only
+uint32_t Trace_GetDropped(void);
+
+#endif // TRACE_H
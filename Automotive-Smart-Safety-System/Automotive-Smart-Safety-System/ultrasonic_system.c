@@ -1,95 +1,171 @@
 #include "ultrasonic_system.h"
 #include "TM4C123GH6PM.h"
-#include "gear_system.h"
+#include "board_pins.h"
+#include "trace.h"
+#include "output_arbiter.h"
+
+// Ranging runs entirely from interrupts:
+//   IDLE --TIMER1A period--> TRIGGER --TIMER2A 10us--> WAIT_ECHO
+//   WAIT_ECHO --echo falling edge or TIMER3A timeout--> IDLE, consumer notified
+typedef enum {
+    RANGE_IDLE,
+    RANGE_TRIGGER,
+    RANGE_WAIT_ECHO
+} RangeState_t;
 
 // Global variables
-static float currentDistance = 0.0f;
-static uint32_t lastMeasurementTime = 0;
+static volatile float currentDistance = 0.0f;   // Written by the ranging interrupts
+static volatile RangeState_t rangeState = RANGE_IDLE;
+static volatile uint8_t rangingActive = 0;
+static TaskHandle_t rangeConsumer = NULL;       // Notified after every measurement
+static uint32_t rangeRateHz = ULTRASONIC_RATE_HZ;
+
+// Echo capture state, owned by WTIMER1A_Handler
+static volatile uint32_t echoRiseTime = 0;
+static volatile uint8_t echoRiseSeen = 0;
+static float cmPerTick = 0.0f;                  // Round-trip distance per timer tick
+
+#define ECHO_IRQ_PRIORITY  5    // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+#define SOUND_CM_PER_S     34300.0f
+#define TRIGGER_PULSE_US   10   // HC-SR04 minimum trigger width
+#define ECHO_TIMEOUT_MS    24   // 4 m target echoes after ~23.3 ms, plus margin
 
-// Initialize ultrasonic sensor and LED pins
+// Initialize ultrasonic sensor pins and timers
 void UltrasonicSystem_Init(void) {
-    // Enable GPIO ports
-    SYSCTL->RCGCGPIO |= (1 << 2) | (1 << 3) | (1 << 4); // Enable GPIOC, GPIOD, GPIOE
-    while((SYSCTL->PRGPIO & ((1 << 2) | (1 << 3) | (1 << 4))) == 0); // Wait for ports to be ready
-    
-    // Configure trigger pin as output
-    TRIGGER_PORT->DIR |= (1 << TRIGGER_PIN);
-    TRIGGER_PORT->DEN |= (1 << TRIGGER_PIN);
-    TRIGGER_PORT->DATA &= ~(1 << TRIGGER_PIN); // Set trigger low initially
-    
-    // Configure echo pin as input with pull-down
-    ECHO_PORT->DIR &= ~(1 << ECHO_PIN);
-    ECHO_PORT->DEN |= (1 << ECHO_PIN);
-    ECHO_PORT->PDR |= (1 << ECHO_PIN);  // Enable pull-down resistor
-    
-    // Configure LED pins as outputs
-    GREEN_LED_PORT->DIR |= (1 << GREEN_LED_PIN);
-    GREEN_LED_PORT->DEN |= (1 << GREEN_LED_PIN);
-    YELLOW_LED_PORT->DIR |= (1 << YELLOW_LED_PIN);
-    YELLOW_LED_PORT->DEN |= (1 << YELLOW_LED_PIN);
-    RED_LED_PORT->DIR |= (1 << RED_LED_PIN);
-    RED_LED_PORT->DEN |= (1 << RED_LED_PIN);
-    
-    // Configure buzzer pin as output
-    GPIOE->DIR |= (1 << 1);  // PE1 as output
-    GPIOE->DEN |= (1 << 1);  // Digital enable
-    GPIOE->DATA &= ~(1 << 1); // Buzzer off initially
-    
-    // Turn off all LEDs initially
-    GREEN_LED_PORT->DATA &= ~(1 << GREEN_LED_PIN);
-    YELLOW_LED_PORT->DATA &= ~(1 << YELLOW_LED_PIN);
-    RED_LED_PORT->DATA &= ~(1 << RED_LED_PIN);
-    
-    // Test trigger pulse
-    TRIGGER_PORT->DATA |= (1 << TRIGGER_PIN);
-    for(volatile int i = 0; i < 1000; i++); // Delay
-    TRIGGER_PORT->DATA &= ~(1 << TRIGGER_PIN);
+    // Configure trigger pin as output, GPIOC is clocked by GpioAccess_Init
+    GPIO_CONFIG(PIN_ULTRA_TRIGGER);
+    GPIO_CLEAR(PIN_ULTRA_TRIGGER); // Set trigger low initially
+    
+    // Configure echo pin as input with pull-down, routed to WT1CCP0
+    GPIO_PORT_OF(PIN_ULTRA_ECHO)->PDR |= GPIO_MASK_OF(PIN_ULTRA_ECHO);  // Enable pull-down resistor
+    GPIO_CONFIG_ALT(PIN_ULTRA_ECHO, 0x7);
+    
+    // Wide Timer 1A timestamps both echo edges in hardware
+    SYSCTL->RCGCWTIMER |= (1 << 1);
+    while((SYSCTL->PRWTIMER & (1 << 1)) == 0);
+    WTIMER1->CTL = 0;                    // Disable during setup
+    WTIMER1->CFG = 0x4;                  // Split into 32-bit halves
+    WTIMER1->TAMR = (1 << 4) |           // Count up
+                    (1 << 2) |           // Edge-time mode
+                    0x3;                 // Capture mode
+    WTIMER1->CTL = (0x3 << 2);           // Capture on both edges
+    WTIMER1->TAILR = 0xFFFFFFFF;         // Free-running over the full range
+    WTIMER1->ICR = (1 << 2);             // Clear capture event
+    WTIMER1->IMR = (1 << 2);             // Capture event interrupt
+    NVIC_SetPriority(WTIMER1A_IRQn, ECHO_IRQ_PRIORITY);
+    NVIC_EnableIRQ(WTIMER1A_IRQn);
+    WTIMER1->CTL |= (1 << 0);            // Start
+    
+    // Half the round trip, per timer tick
+    cmPerTick = SOUND_CM_PER_S / 2.0f / (float)SystemCoreClock;
+    
+    // Timer 1A paces measurements, 2A times the trigger pulse, 3A the echo timeout
+    SYSCTL->RCGCTIMER |= (1 << 1) | (1 << 2) | (1 << 3);
+    while((SYSCTL->PRTIMER & ((1 << 1) | (1 << 2) | (1 << 3))) != ((1 << 1) | (1 << 2) | (1 << 3)));
+    TIMER1->CTL = 0;
+    TIMER1->CFG = 0;                     // 32-bit timer
+    TIMER1->TAMR = 0x2;                  // Periodic
+    TIMER2->CTL = 0;
+    TIMER2->CFG = 0;
+    TIMER2->TAMR = 0x1;                  // One-shot
+    TIMER3->CTL = 0;
+    TIMER3->CFG = 0;
+    TIMER3->TAMR = 0x1;                  // One-shot
+    TIMER1->ICR = 1;
+    TIMER2->ICR = 1;
+    TIMER3->ICR = 1;
+    TIMER1->IMR = 1;                     // Time-out interrupts
+    TIMER2->IMR = 1;
+    TIMER3->IMR = 1;
+    NVIC_SetPriority(TIMER1A_IRQn, ECHO_IRQ_PRIORITY);
+    NVIC_SetPriority(TIMER2A_IRQn, ECHO_IRQ_PRIORITY);
+    NVIC_SetPriority(TIMER3A_IRQn, ECHO_IRQ_PRIORITY);
+    NVIC_EnableIRQ(TIMER1A_IRQn);
+    NVIC_EnableIRQ(TIMER2A_IRQn);
+    NVIC_EnableIRQ(TIMER3A_IRQn);
 }
 
-// Measure distance using ultrasonic sensor
-static float MeasureDistance(void) {
-    uint32_t echoTime = 0;
-    float distance = 0.0f;
-    uint32_t timeout = 0;
-    
-    // Send trigger pulse (10us)
-    TRIGGER_PORT->DATA &= ~(1 << TRIGGER_PIN);  // Ensure trigger is low
-    for(volatile int i = 0; i < 100; i++);      // 10us delay
-    TRIGGER_PORT->DATA |= (1 << TRIGGER_PIN);   // Set trigger high
-    for(volatile int i = 0; i < 100; i++);      // 10us delay
-    TRIGGER_PORT->DATA &= ~(1 << TRIGGER_PIN);  // Set trigger low
-    
-    // Wait for echo to go high with timeout
-    timeout = 0;
-    while(!(ECHO_PORT->DATA & (1 << ECHO_PIN))) {
-        timeout++;
-        if(timeout > 100000) {  // Reduced timeout to 100ms
-            return 0.0f;  // Return 0 if no echo received
-        }
+// Restart a one-shot timer so it expires 'ticks' from now
+static void ArmOneShot(TIMER0_Type *timer, uint32_t ticks) {
+    timer->CTL = 0;
+    timer->TAILR = ticks;
+    timer->TAV = ticks;
+    timer->ICR = 1;
+    timer->CTL = 1;
+}
+
+// Publish a measurement (0 for no echo) and wake the consumer
+static void RangeComplete(float distance) {
+    BaseType_t woken = pdFALSE;
+    
+    TIMER3->CTL = 0;
+    currentDistance = distance;
+    echoRiseSeen = 0;
+    rangeState = RANGE_IDLE;
+    
+    if (rangeConsumer != NULL) {
+        vTaskNotifyGiveFromISR(rangeConsumer, &woken);
     }
+    portYIELD_FROM_ISR(woken);
+}
+
+// Measurement period: raise the trigger, TIMER2A drops it again
+void TIMER1A_Handler(void) {
+    TIMER1->ICR = 1;
+    
+    // Previous measurement still running, skip this slot
+    if (rangeState != RANGE_IDLE) return;
+    
+    GPIO_SET(PIN_ULTRA_TRIGGER);
+    rangeState = RANGE_TRIGGER;
+    ArmOneShot(TIMER2, (SystemCoreClock / 1000000) * TRIGGER_PULSE_US);
+}
+
+// End of the trigger pulse, start waiting for the echo
+void TIMER2A_Handler(void) {
+    TIMER2->ICR = 1;
+    
+    GPIO_CLEAR(PIN_ULTRA_TRIGGER);
+    echoRiseSeen = 0;
+    rangeState = RANGE_WAIT_ECHO;
+    ArmOneShot(TIMER3, (SystemCoreClock / 1000) * ECHO_TIMEOUT_MS);
+}
+
+// No echo in time, report an invalid reading
+void TIMER3A_Handler(void) {
+    TIMER3->ICR = 1;
     
-    // Reset echo time counter
-    echoTime = 0;
-    
-    // Wait for echo to go low with timeout
-    timeout = 0;
-    while(ECHO_PORT->DATA & (1 << ECHO_PIN)) {
-        echoTime++;
-        timeout++;
-        if(timeout > 100000) {  // Reduced timeout to 100ms
-            return 0.0f;  // Return 0 if echo doesn't go low
-        }
+    if (rangeState == RANGE_WAIT_ECHO) {
+        RangeComplete(0.0f);
     }
+}
+
+// Echo capture: the first edge of a measurement window is the rising one and
+// its timestamp is kept, the second closes the pulse and converts its width to
+// distance. The order comes from the window, not from the pin level, which a
+// short echo may already have changed again by the time the ISR reads it.
+void WTIMER1A_Handler(void) {
+    uint32_t captured;
+    float distance;
+    
+    WTIMER1->ICR = (1 << 2);
+    captured = WTIMER1->TAR;
+    
+    // Edges outside a measurement window are noise
+    if (rangeState != RANGE_WAIT_ECHO) return;
     
-    // Calculate distance (speed of sound = 340 m/s)
-    // distance = (time * speed) / 2
-    // time in microseconds, speed in cm/microsecond
-    distance = (echoTime * 0.034) / 2;
+    if (!echoRiseSeen) {
+        echoRiseTime = captured;
+        echoRiseSeen = 1;
+    } else {
+        distance = (float)(captured - echoRiseTime) * cmPerTick;
     
-    // Limit maximum distance to 150cm
-    if(distance > 150.0f) distance = 150.0f;
+        // Limit maximum distance to 150cm
+        if(distance > 150.0f) distance = 150.0f;
     
-    return distance;
+        Trace_Record(TRACE_ECHO_CAPTURE, (uint16_t)(distance * 10.0f));
+        RangeComplete(distance);
+    }
 }
 
 // Get current distance
@@ -97,70 +173,84 @@ float UltrasonicSystem_GetDistance(void) {
     return currentDistance;
 }
 
-// Update distance measurement
-void UltrasonicSystem_Update(void) {
-    // Only measure distance when in reverse gear
-    if(GearSystem_GetCurrentGear() == GEAR_REVERSE) {
-        currentDistance = MeasureDistance();
-        lastMeasurementTime = xTaskGetTickCount();
-    } else {
-        currentDistance = 0.0f;
+// Task notified (default index) after every measurement
+void UltrasonicSystem_SetConsumer(TaskHandle_t consumer) {
+    rangeConsumer = consumer;
+}
+
+// Measurements per second, takes effect on the next period. Limited so that
+// the trigger and the echo timeout fit in one period, otherwise every missing
+// echo would cost the next slot.
+void UltrasonicSystem_SetRate(uint32_t hz) {
+    if (hz == 0) hz = 1;
+    if (hz > ULTRASONIC_MAX_RATE_HZ) hz = ULTRASONIC_MAX_RATE_HZ;
+    rangeRateHz = hz;
+    if (rangingActive) {
+        TIMER1->TAILR = SystemCoreClock / rangeRateHz - 1;
     }
 }
 
-// Turn off all LEDs
-void UltrasonicSystem_TurnOffLEDs(void) {
-    GREEN_LED_PORT->DATA &= ~(1 << GREEN_LED_PIN);
-    YELLOW_LED_PORT->DATA &= ~(1 << YELLOW_LED_PIN);
-    RED_LED_PORT->DATA &= ~(1 << RED_LED_PIN);
+// Start periodic ranging
+void UltrasonicSystem_Start(void) {
+    if (rangingActive) return;
+    
+    taskENTER_CRITICAL();
+    rangeState = RANGE_IDLE;
+    TIMER1->CTL = 0;
+    TIMER1->TAILR = SystemCoreClock / rangeRateHz - 1;
+    TIMER1->TAV = SystemCoreClock / rangeRateHz - 1;
+    TIMER1->ICR = 1;
+    TIMER1->CTL = 1;
+    rangingActive = 1;
+    taskEXIT_CRITICAL();
 }
 
-// Turn off buzzer
-void UltrasonicSystem_TurnOffBuzzer(void) {
-    GPIOE->DATA &= ~(1 << 1); // Turn off PE1 (buzzer)
+// Stop ranging and abandon any measurement in flight
+void UltrasonicSystem_Stop(void) {
+    taskENTER_CRITICAL();
+    TIMER1->CTL = 0;
+    TIMER2->CTL = 0;
+    TIMER3->CTL = 0;
+    GPIO_CLEAR(PIN_ULTRA_TRIGGER);
+    rangeState = RANGE_IDLE;
+    echoRiseSeen = 0;
+    currentDistance = 0.0f;
+    rangingActive = 0;
+    taskEXIT_CRITICAL();
 }
 
-// Update LED indicators based on distance
-void UltrasonicSystem_UpdateLEDs(float distance) {
-    // Turn off all LEDs first
-    GREEN_LED_PORT->DATA &= ~(1 << GREEN_LED_PIN);
-    YELLOW_LED_PORT->DATA &= ~(1 << YELLOW_LED_PIN);
-    RED_LED_PORT->DATA &= ~(1 << RED_LED_PIN);
-    
-    // Update LEDs based on distance
-    if(distance > SAFE_DISTANCE) {
-        GREEN_LED_PORT->DATA |= (1 << GREEN_LED_PIN);
-    } else if(distance > CAUTION_DISTANCE) {
-        YELLOW_LED_PORT->DATA |= (1 << YELLOW_LED_PIN);
-    } else if(distance > 0.0f) {  // Only turn on red LED if we have a valid reading
-        RED_LED_PORT->DATA |= (1 << RED_LED_PIN);
+// Range only while in reverse gear
+void UltrasonicSystem_Update(uint8_t reverse) {
+    if(reverse) {
+        UltrasonicSystem_Start();
+    } else if (rangingActive) {
+        UltrasonicSystem_Stop();
     }
 }
 
-// Update buzzer based on distance
-void UltrasonicSystem_UpdateBuzzer(float distance) {
-    static uint32_t lastBeepTime = 0;
-    uint32_t currentTime = xTaskGetTickCount();
-    uint32_t beepInterval;
-    
-    // Only beep if we have a valid reading
+// Turn off all LEDs and the buzzer, a higher owner may still hold them
+void UltrasonicSystem_TurnOffIndicators(void) {
+    OutputArbiter_Release(OUTPUT_OWNER_PARKING);
+}
+
+// Update LEDs and buzzer based on distance. The parking indication claims
+// all of them, the arbiter gives the buzzer to a door warning if one is on.
+void UltrasonicSystem_UpdateIndicators(float distance) {
+    // Only indicate if we have a valid reading
     if(distance <= 0.0f) {
-        GPIOE->DATA &= ~(1 << 1); // Turn off buzzer
+        UltrasonicSystem_TurnOffIndicators();
         return;
     }
     
-    // Calculate beep interval based on distance
+    // LED and beep interval based on distance
     if(distance > SAFE_DISTANCE) {
-        beepInterval = 1000; // 1 second when safe
+        OutputArbiter_Request(OUTPUT_OWNER_PARKING, OUTPUT_LEDS | OUTPUT_BUZZER,
+                              OUTPUT_GREEN_LED, &BUZZER_PARK_FAR);      // 1 second when safe
     } else if(distance > CAUTION_DISTANCE) {
-        beepInterval = 500; // 0.5 seconds in caution zone
+        OutputArbiter_Request(OUTPUT_OWNER_PARKING, OUTPUT_LEDS | OUTPUT_BUZZER,
+                              OUTPUT_YELLOW_LED, &BUZZER_PARK_CAUTION); // 0.5 seconds in caution zone
     } else {
-        beepInterval = 200; // 0.2 seconds in danger zone
-    }
-    
-    // Toggle buzzer based on interval
-    if(currentTime - lastBeepTime >= pdMS_TO_TICKS(beepInterval)) {
-        GPIOE->DATA ^= (1 << 1); // Toggle PE1 (buzzer)
-        lastBeepTime = currentTime;
+        OutputArbiter_Request(OUTPUT_OWNER_PARKING, OUTPUT_LEDS | OUTPUT_BUZZER,
+                              OUTPUT_RED_LED, &BUZZER_PARK_DANGER);     // 0.2 seconds in danger zone
     }
-} 
\ No newline at end of file
+}
\ No newline at end of file
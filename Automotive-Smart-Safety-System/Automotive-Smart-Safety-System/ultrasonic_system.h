@@ -7,31 +7,26 @@
 #include "queue.h"
 #include "semphr.h"
 
-// Pin definitions for ultrasonic sensor
-#define TRIGGER_PORT GPIOC
-#define TRIGGER_PIN 5
-#define ECHO_PORT GPIOC
-#define ECHO_PIN 6
-
-// Pin definitions for LED indicators
-#define GREEN_LED_PORT GPIOE
-#define GREEN_LED_PIN 0
-#define YELLOW_LED_PORT GPIOD
-#define YELLOW_LED_PIN 6
-#define RED_LED_PORT GPIOD
-#define RED_LED_PIN 0
+// Sensor on PIN_ULTRA_TRIGGER (PC5) and PIN_ULTRA_ECHO (PC6)
 
 // Distance thresholds (in cm)
 #define SAFE_DISTANCE 100.0f
 #define CAUTION_DISTANCE 30.0f
 
+// Measurements per second while ranging, independent of the task period
+#define ULTRASONIC_RATE_HZ 25
+#define ULTRASONIC_MAX_RATE_HZ 40      // Period of 25 ms, trigger plus the 24 ms echo timeout
+#define ULTRASONIC_GEAR_POLL_MS 100    // Gear check period while not ranging
+
 // Function prototypes
 void UltrasonicSystem_Init(void);
 float UltrasonicSystem_GetDistance(void);
-void UltrasonicSystem_Update(void);
-void UltrasonicSystem_UpdateLEDs(float distance);
-void UltrasonicSystem_UpdateBuzzer(float distance);
-void UltrasonicSystem_TurnOffLEDs(void);
-void UltrasonicSystem_TurnOffBuzzer(void);
+void UltrasonicSystem_Update(uint8_t reverse);
+void UltrasonicSystem_Start(void);
+void UltrasonicSystem_Stop(void);
+void UltrasonicSystem_SetRate(uint32_t hz);
+void UltrasonicSystem_SetConsumer(TaskHandle_t consumer);
+void UltrasonicSystem_UpdateIndicators(float distance);   // LEDs and buzzer for a reading
+void UltrasonicSystem_TurnOffIndicators(void);
 
 #endif // ULTRASONIC_SYSTEM_H 
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "vehicle_state.h"
+#include "TM4C123GH6PM.h"
+
+// Sequence lock. A writer makes the sequence odd, changes one field and makes
+// it even again, all with interrupts up to configMAX_SYSCALL_INTERRUPT_PRIORITY
+// masked so writers never interleave. A reader copies the whole struct and
+// retries if the sequence was odd or moved meanwhile. Readers never block a
+// writer, and since every writer masks the readers' interrupt levels, a
+// reader only ever retries after being preempted, never spins.
+
+static volatile uint32_t sequence = 0;
+static volatile uint32_t retries = 0;
+
+// Power-on defaults of the modules that own the fields
+static VehicleState_t state = {
+    0,                 // speed
+    GEAR_DRIVE,        // gear
+    1,                 // ignitionOn
+    DOORS_UNLOCKED,    // doorLock
+    DOOR_CLOSED        // doorOpen
+};
+
+void VehicleState_Read(VehicleState_t *snapshot) {
+    uint32_t start;
+
+    while (1) {
+        start = sequence;
+        __DMB();
+        *snapshot = state;
+        __DMB();
+        if (!(start & 1) && start == sequence) return;
+        retries++;
+    }
+}
+
+uint32_t VehicleState_GetRetries(void) {
+    return retries;
+}
+
+// The FROM_ISR mask calls only raise BASEPRI, so they are valid in tasks too
+static UBaseType_t BeginWrite(void) {
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    sequence++;
+    __DMB();
+    return mask;
+}
+
+static void EndWrite(UBaseType_t mask) {
+    __DMB();
+    sequence++;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+void VehicleState_SetSpeed(Speed_t speed) {
+    UBaseType_t mask = BeginWrite();
+    state.speed = speed;
+    EndWrite(mask);
+}
+
+void VehicleState_SetGear(Gear_t gear) {
+    UBaseType_t mask = BeginWrite();
+    state.gear = gear;
+    EndWrite(mask);
+}
+
+void VehicleState_SetIgnition(uint8_t on) {
+    UBaseType_t mask = BeginWrite();
+    state.ignitionOn = on;
+    EndWrite(mask);
+}
+
+void VehicleState_SetDoorLock(DoorState_t doorLock) {
+    UBaseType_t mask = BeginWrite();
+    state.doorLock = doorLock;
+    EndWrite(mask);
+}
+
+void VehicleState_SetDoorOpen(DoorOpenState_t doorOpen) {
+    UBaseType_t mask = BeginWrite();
+    state.doorOpen = doorOpen;
+    EndWrite(mask);
+}
@@ -0,0 +1,28 @@
+#ifndef VEHICLE_STATE_H
+#define VEHICLE_STATE_H
+
+#include <stdint.h>
+#include "speed_system.h"
+#include "gear_system.h"
+#include "Door.h"
+
+// Shared vehicle state. Each field has one writer module; everyone else
+// takes a snapshot with VehicleState_Read once per job and decides on that.
+typedef struct {
+    Speed_t speed;               // Written by the ADC interrupt (speed_system.c)
+    Gear_t gear;                 // gear_system.c
+    uint8_t ignitionOn;          // Doors.c
+    DoorState_t doorLock;        // Doors.c
+    DoorOpenState_t doorOpen;    // Doors.c
+} VehicleState_t;
+
+// Function prototypes
+void VehicleState_Read(VehicleState_t *snapshot);    // Lock-free, any task or ISR
+uint32_t VehicleState_GetRetries(void);              // Reads repeated after a concurrent write
+void VehicleState_SetSpeed(Speed_t speed);           // Setters: task or ISR
+void VehicleState_SetGear(Gear_t gear);
+void VehicleState_SetIgnition(uint8_t on);
+void VehicleState_SetDoorLock(DoorState_t state);
+void VehicleState_SetDoorOpen(DoorOpenState_t state);
+
+#endif // VEHICLE_STATE_H